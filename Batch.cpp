@@ -0,0 +1,300 @@
+#include "Batch.hpp"
+
+#include "EngineFactory.hpp"
+#include "Fen.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <charconv>
+
+#define BATCH_QUEUE_PER_THREAD 64 // number of positions that are queued per thread before adding a position blocks
+
+/*
+ * Files ending in .csv are read as lichess puzzle CSVs, all other files as EPD.
+ */
+Batch::Format Batch::formatOf(std::string_view path) {
+    return path.ends_with(".csv") ? Format::Csv : Format::Epd;
+}
+
+/*
+ * Removes the next comma separated field from the given line and returns it.
+ */
+static std::string_view nextColumn(std::string_view &line) {
+    auto column = line.substr(0, line.find(','));
+    line.remove_prefix(std::min(column.size() + 1, line.size()));
+    return column;
+}
+
+/*
+ * Parses a line of the lichess puzzle CSV: `PuzzleId,FEN,Moves,...`. The first of the moves is played by the opponent
+ * before the puzzle starts, so the position to analyse is the one after that move, a line with an illegal first move
+ * is not a position. A CSV with only an id and a FEN is read as well.
+ */
+static std::optional<Batch::Position> parseCsvLine(std::string_view line, std::size_t index) {
+    auto id = nextColumn(line);
+    auto board = Fen::createBoard(nextColumn(line));
+
+    if (!board.has_value())
+        return std::nullopt;
+
+    auto moves = nextColumn(line);
+    auto firstMove = moves.substr(0, moves.find(' '));
+
+    if (!firstMove.empty()) {
+        auto move = Move::fromUci(firstMove);
+        if (!move.has_value())
+            return std::nullopt;
+
+        Board::MoveVec moves;
+        board->legalMoves(moves);
+
+        if (std::find(moves.begin(), moves.end(), move.value()) == moves.end())
+            return std::nullopt;
+
+        board->makeMove(move.value());
+    }
+
+    return Batch::Position{index, std::string(id), board.value()};
+}
+
+/*
+ * Parses a line of an EPD file, the id operation is used as the id of the position.
+ */
+static std::optional<Batch::Position> parseEpdLine(std::string_view line, std::size_t index) {
+    auto epd = Fen::parseEpd(line);
+
+    if (!epd.has_value())
+        return std::nullopt;
+
+    auto id = epd->operation("id").value_or(std::string_view());
+    return Batch::Position{index, std::string(id), epd->board};
+}
+
+/*
+ * Parses a line of the given format. Empty lines, comments starting with '#' and the header of a CSV file are not
+ * positions.
+ */
+std::optional<Batch::Position> Batch::parseLine(std::string_view line, Format format, std::size_t index) {
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    if (line.empty() || line.front() == '#' || line.starts_with("PuzzleId,"))
+        return std::nullopt;
+
+    return format == Format::Csv ? parseCsvLine(line, index) : parseEpdLine(line, index);
+}
+
+/*
+ * Records the depth of the last completed iteration of the best line.
+ */
+class DepthListener : public SearchListener {
+public:
+
+    void iterationCompleted(const SearchInfo &info) override {
+        if (info.multiPv == 1)
+            depth = info.depth;
+    }
+
+    void currentMove(int, const Move &, int) override {}
+
+    int depth = 0;
+};
+
+/*
+ * Searches the given position, positions are independent so the game history of the engine is cleared first.
+ */
+Batch::Result Batch::analyse(Engine &engine, const Position &position, const SearchLimits &limits) {
+    DepthListener listener;
+    engine.setSearchListener(&listener);
+    engine.setGameHistory({});
+
+    auto start = std::chrono::steady_clock::now();
+    auto pv = engine.pv(position.board, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    engine.setSearchListener(nullptr);
+
+    auto statistics = engine.statistics();
+    auto bestMove = pv.length() > 0 ? std::optional<Move>(*pv.begin()) : std::nullopt;
+
+    return {position.index, position.id, Fen::toFen(position.board), bestMove, pv.score(), pv.isMate(),
+            listener.depth, statistics ? statistics->nodes : 0, elapsed};
+}
+
+static void appendJsonString(std::string &json, std::string_view text) {
+    json += '"';
+
+    for (auto c : text) {
+        switch (c) {
+            case '"': json += "\\\""; break;
+            case '\\': json += "\\\\"; break;
+            case '\n': json += "\\n"; break;
+            case '\r': json += "\\r"; break;
+            case '\t': json += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char hex[] = "0123456789abcdef";
+                    json += "\\u00";
+                    json += hex[c >> 4];
+                    json += hex[c & 0xf];
+                } else {
+                    json += c;
+                }
+        }
+    }
+
+    json += '"';
+}
+
+template<typename T>
+static void appendNumber(std::string &json, T number) {
+    char digits[24];
+    auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+    json.append(digits, end);
+}
+
+/*
+ * Formats the result as a single line of JSON. Mate scores are given in moves, like UCI does.
+ */
+std::string Batch::toJson(const Result &result) {
+    auto json = std::string("{\"index\":");
+    appendNumber(json, result.index);
+
+    json += ",\"id\":";
+    appendJsonString(json, result.id);
+    json += ",\"fen\":";
+    appendJsonString(json, result.fen);
+
+    json += ",\"bestmove\":";
+    if (result.bestMove.has_value()) {
+        appendJsonString(json, result.bestMove->toUci());
+    } else {
+        json += "null";
+    }
+
+    if (result.mate) {
+        auto moves = result.score < 0 ? std::floor(result.score / 2.0) : std::ceil(result.score / 2.0);
+        json += ",\"score\":{\"mate\":";
+        appendNumber(json, static_cast<long>(moves));
+    } else {
+        json += ",\"score\":{\"cp\":";
+        appendNumber(json, result.score);
+    }
+
+    json += "},\"depth\":";
+    appendNumber(json, result.depth);
+    json += ",\"nodes\":";
+    appendNumber(json, result.nodes);
+    json += ",\"time\":";
+    appendNumber(json, result.time.count());
+    json += '}';
+
+    return json;
+}
+
+Batch::Analyser::Analyser(int threads, const SearchLimits &limits, ResultCallback onResult) :
+        limits_(limits), onResult_(std::move(onResult)) {
+    for (int i = 0; i < std::max(threads, 1); i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->engine = EngineFactory::createEngine();
+        workers_.push_back(std::move(worker));
+    }
+
+    for (std::size_t i = 0; i < workers_.size(); i++)
+        workers_[i]->thread = std::thread(&Analyser::work, this, i);
+}
+
+Batch::Analyser::~Analyser() {
+    finish();
+}
+
+/*
+ * Queues a position for analysis, blocks while the queues are full. Positions must be added from a single thread.
+ */
+void Batch::Analyser::add(Position position) {
+    {
+        std::unique_lock lock(mutex_);
+        condition_.wait(lock, [this] { return queued_ < BATCH_QUEUE_PER_THREAD * workers_.size(); });
+    }
+
+    auto &worker = *workers_[nextWorker_++ % workers_.size()];
+
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.queue.push_back(std::move(position));
+    }
+
+    // the position is only announced once it is in a queue, so a thread that claims it always finds it
+    {
+        std::lock_guard lock(mutex_);
+        queued_++;
+    }
+
+    condition_.notify_all();
+}
+
+/*
+ * Waits until all queued positions are analysed and stops the threads.
+ */
+void Batch::Analyser::finish() {
+    {
+        std::lock_guard lock(mutex_);
+        finished_ = true;
+    }
+
+    condition_.notify_all();
+
+    for (auto &worker : workers_) {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+void Batch::Analyser::work(std::size_t worker) {
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            condition_.wait(lock, [this] { return queued_ > 0 || finished_; });
+
+            if (queued_ == 0)
+                return;
+
+            queued_--;
+        }
+
+        condition_.notify_all();
+
+        auto position = take(worker);
+        auto result = analyse(*workers_[worker]->engine, position, limits_);
+
+        std::lock_guard lock(resultMutex_);
+        onResult_(result);
+    }
+}
+
+/*
+ * Takes the next position of the given thread, or steals the last position of another thread when its own queue is
+ * empty. The caller claimed a position, so there is at least one in the queues.
+ */
+Batch::Position Batch::Analyser::take(std::size_t worker) {
+    while (true) {
+        for (std::size_t i = 0; i < workers_.size(); i++) {
+            auto &victim = *workers_[(worker + i) % workers_.size()];
+            std::lock_guard lock(victim.mutex);
+
+            if (victim.queue.empty())
+                continue;
+
+            Position position;
+            if (i == 0) {
+                position = std::move(victim.queue.front());
+                victim.queue.pop_front();
+            } else {
+                position = std::move(victim.queue.back());
+                victim.queue.pop_back();
+            }
+
+            return position;
+        }
+    }
+}
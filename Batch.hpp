@@ -0,0 +1,107 @@
+#ifndef CHESS_ENGINE_BATCH_HPP
+#define CHESS_ENGINE_BATCH_HPP
+
+#include "Board.hpp"
+#include "Engine.hpp"
+#include "SearchLimits.hpp"
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Analysis of many positions at once, e.g. from EPD files or lichess puzzle CSVs.
+ */
+namespace Batch {
+    enum class Format {
+        Epd,
+        Csv
+    };
+
+    struct Position {
+        // number of the position in the input, starting at 0
+        std::size_t index;
+        std::string id;
+        Board board;
+    };
+
+    struct Result {
+        std::size_t index;
+        std::string id;
+        std::string fen;
+        std::optional<Move> bestMove;
+        long score;
+        bool mate;
+        int depth;
+        uint64_t nodes;
+        std::chrono::milliseconds time;
+    };
+
+    Format formatOf(std::string_view path);
+
+    std::optional<Position> parseLine(std::string_view line, Format format, std::size_t index);
+
+    Result analyse(Engine &engine, const Position &position, const SearchLimits &limits);
+
+    std::string toJson(const Result &result);
+
+    /*
+     * Analyses positions on a pool of threads, every thread has its own engine.
+     *
+     * Positions are handed out round robin to the queues of the threads. A thread that runs out of positions steals
+     * from the back of the queues of the other threads, so a few expensive positions don't leave the other threads
+     * idle. The number of queued positions is bounded, so the input can be streamed.
+     */
+    class Analyser {
+    public:
+
+        using ResultCallback = std::function<void(const Result &)>;
+
+        Analyser(int threads, const SearchLimits &limits, ResultCallback onResult);
+
+        ~Analyser();
+
+        void add(Position position);
+
+        void finish();
+
+    private:
+
+        struct Worker {
+            std::unique_ptr<Engine> engine;
+            std::mutex mutex;
+            std::deque<Position> queue;
+            std::thread thread;
+        };
+
+        void work(std::size_t worker);
+
+        Position take(std::size_t worker);
+
+        SearchLimits limits_;
+        ResultCallback onResult_;
+        std::vector<std::unique_ptr<Worker>> workers_;
+        std::size_t nextWorker_ = 0;
+
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        // positions that are queued and not yet claimed by a thread
+        std::size_t queued_ = 0;
+        bool finished_ = false;
+
+        // results are reported one at a time
+        std::mutex resultMutex_;
+    };
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "Board.hpp"
+#include "Fen.hpp"
+#include "MoveGenerator.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+using U64 = uint64_t;
+using SlidingAttacks = void (*)(const U64[2], const U64[2], U64, U64[2], U64[2]);
+
+/*
+ * Positions from the opening to the endgame, with a varying number of sliders.
+ */
+static const std::vector<std::string> positions = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "4k3/8/8/3q4/8/8/2B5/4K2R w K - 0 1"
+};
+
+/*
+ * Runs the given attack generator for the sliders of both colors of every position and returns the average time per
+ * position in nanoseconds. The checksum prevents the compiler from optimizing the calls away.
+ */
+static double run(SlidingAttacks generator, const std::vector<Board> &boards, int iterations, U64 &checksum) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; i++) {
+        for (auto &board : boards) {
+            auto bitboards = board.getBitboards();
+            U64 straight[2] = {bitboards[1] | bitboards[2], bitboards[7] | bitboards[8]};
+            U64 diagonal[2] = {bitboards[1] | bitboards[3], bitboards[7] | bitboards[9]};
+            U64 straightAttacks[2], diagonalAttacks[2];
+
+            generator(straight, diagonal, board.getEmptySquares(), straightAttacks, diagonalAttacks);
+            checksum += straightAttacks[0] ^ straightAttacks[1] ^ diagonalAttacks[0] ^ diagonalAttacks[1];
+        }
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() / (double(iterations) * double(boards.size()));
+}
+
+/*
+ * Benchmarks the set-wise slider attack generator against generating the attacks of every slider separately.
+ * The per-square generator uses the slider backend that is selected at startup, unless one is forced.
+ *
+ * Usage: penguin-bench [--backend=loop|pext] [iterations]
+ */
+int main(int argc, char *argv[]) {
+    int iterations = 200000;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--backend=loop") {
+            MoveGenerator::setSliderBackend(MoveGenerator::SliderBackend::Loop);
+        } else if (arg == "--backend=pext") {
+            if (!MoveGenerator::setSliderBackend(MoveGenerator::SliderBackend::Pext)) {
+                std::cerr << "PEXT is not supported on this CPU\n";
+                return EXIT_FAILURE;
+            }
+        } else {
+            iterations = std::atoi(argv[i]);
+        }
+    }
+
+    std::vector<Board> boards;
+    for (auto &fen : positions)
+        boards.push_back(Fen::createBoard(fen).value());
+
+    U64 perSquareChecksum = 0, setwiseChecksum = 0;
+    auto perSquare = run(MoveGenerator::slidingAttacksPerSquare, boards, iterations, perSquareChecksum);
+    auto setwise = run(MoveGenerator::slidingAttacks, boards, iterations, setwiseChecksum);
+
+    std::cout << "per square (" << MoveGenerator::sliderBackendName() << "): " << perSquare << " ns/position\n";
+    std::cout << "kogge-stone (" << MoveGenerator::slidingAttacksImplementation() << "): " << setwise
+              << " ns/position\n";
+
+    if (perSquareChecksum != setwiseChecksum) {
+        std::cerr << "Attack maps differ\n";
+        return EXIT_FAILURE;
+    }
+}
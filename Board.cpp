@@ -1,12 +1,14 @@
 #include "Board.hpp"
 #include "MoveGenerator.h"
+#include "Evaluate.h"
 
 #include <ostream>
 #include <iostream>
 #include <algorithm>
 #include <bitset>
 #include <memory>
-#include <random>
+#include <bit>
+#include <cstdlib>
 
 #define FILE_A 0x0101010101010101L
 #define FILE_B 0x0202020202020202L
@@ -29,18 +31,67 @@
 #define NBB 12
 #define NSQ 64
 
+#define GOOD_CAPTURE_SCORE 10000 // bonus for captures that do not lose material
+
 using U64 = uint64_t;
 
-Board::Board() {
+/*
+ * Random keys used for Zobrist hashing.
+ *
+ * The keys are generated at compile time from a fixed seed, so that hashes are reproducible between runs.
+ * Source: https://www.chessprogramming.org/Zobrist_Hashing
+ */
+struct ZobristKeys {
+    U64 pieces[NBB][NSQ];
+    U64 castling[16];
+    U64 enPassant[8];
+    U64 black;
+};
 
-    // initialize bitboards
-    bitboards = std::vector<U64>(NBB);
-    for (int i = 0; i < NBB; i++) {
-        bitboards[i] = 0UL;
-    }
+/*
+ * SplitMix64 pseudo-random number generator, usable in constant expressions.
+ * Source: https://prng.di.unimi.it/splitmix64.c
+ */
+static constexpr U64 splitMix64(U64 &state) {
+    U64 z = (state += 0x9E3779B97F4A7C15UL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    return z ^ (z >> 31);
+}
+
+static constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys{};
+    U64 state = 0x9E3779B97F4A7C15UL;
+
+    for (auto &bitboard: keys.pieces)
+        for (auto &key: bitboard)
+            key = splitMix64(state);
+
+    for (auto &key: keys.castling)
+        key = splitMix64(state);
+
+    for (auto &key: keys.enPassant)
+        key = splitMix64(state);
+
+    keys.black = splitMix64(state);
+    return keys;
+}
+
+static constexpr ZobristKeys zobrist = makeZobristKeys();
+
+static U64 castlingKey(CastlingRights cr) {
+    return zobrist.castling[static_cast<int>(cr)];
+}
+
+static U64 enPassantKey(const std::optional<Square> &square) {
+    return square ? zobrist.enPassant[square->file()] : 0UL;
+}
+
+Board::Board() {
 
     turn_ = PieceColor::White;
     cr_ = CastlingRights::All;
+    hash_ = castlingKey(cr_);
 }
 
 bool Board::isNewGame() const {
@@ -72,8 +123,19 @@ void Board::setPiece(const Square &square, const Piece::Optional &piece) {
         removePiece(square);
 
         // set piece
-        auto idx = bitboardMap.at(*piece);
+        auto idx = piece->bitboardIndex();
         bitboards[idx] |= bit << square.index();
+        occupancy_[idx / 6] |= bit << square.index();
+        mailbox_[square.index()] = piece;
+        attackInfo_.reset();
+        hash_ ^= zobrist.pieces[idx][square.index()];
+        pieceSquareScore_ += Evaluate::pieceSquareScore(idx, square.index());
+        phase_ += Evaluate::phaseWeight(idx);
+
+        if (piece->type() == PieceType::Pawn)
+            pawnHash_ ^= zobrist.pieces[idx][square.index()];
+
+        recordChange(idx, square.index(), true);
     }
 }
 
@@ -81,9 +143,26 @@ void Board::setPiece(const Square &square, const Piece::Optional &piece) {
  * Removes the piece on the given square.
  */
 void Board::removePiece(const Square &square) {
-    for (auto &bitboard: bitboards) {
-        bitboard &= ~(bit << square.index());
-    }
+    auto piece = mailbox_[square.index()];
+    if (!piece)
+        return;
+
+    auto i = piece->bitboardIndex();
+    U64 mask = bit << square.index();
+
+    bitboards[i] &= ~mask;
+    occupancy_[i / 6] &= ~mask;
+    mailbox_[square.index()] = std::nullopt;
+    attackInfo_.reset();
+
+    hash_ ^= zobrist.pieces[i][square.index()];
+    pieceSquareScore_ -= Evaluate::pieceSquareScore(i, square.index());
+    phase_ -= Evaluate::phaseWeight(i);
+
+    if (piece->type() == PieceType::Pawn)
+        pawnHash_ ^= zobrist.pieces[i][square.index()];
+
+    recordChange(i, square.index(), false);
 }
 
 /*
@@ -115,19 +194,13 @@ Piece::Optional Board::piece(const Square &square) const {
  * If the square is empty, returns std::nullopt.
  */
 Piece::Optional Board::piece(unsigned int idx) const {
-    U64 mask = bit << idx;
-
-    for (int i = 0; i < NBB; i++) {
-        auto bitboard = this->bitboards[i];
-        if (bitboard & mask) {
-            return bitboardTypes[i];
-        }
-    }
-
-    return std::nullopt;
+    return mailbox_[idx];
 }
 
 void Board::setTurn(PieceColor turn) {
+    if (turn != turn_)
+        hash_ ^= zobrist.black;
+
     turn_ = turn;
 }
 
@@ -136,6 +209,7 @@ PieceColor Board::turn() const {
 }
 
 void Board::setCastlingRights(CastlingRights cr) {
+    hash_ ^= castlingKey(cr_) ^ castlingKey(cr);
     cr_ = cr;
 }
 
@@ -144,13 +218,36 @@ CastlingRights Board::castlingRights() const {
 }
 
 void Board::setEnPassantSquare(const Square::Optional &square) {
-    enPassantSquare_ = *square;
+    hash_ ^= enPassantKey(enPassantSquare_) ^ enPassantKey(square);
+    enPassantSquare_ = square;
 }
 
 Square::Optional Board::enPassantSquare() const {
     return enPassantSquare_;
 }
 
+void Board::setHalfmoveClock(unsigned clock) {
+    halfmoveClock_ = clock;
+}
+
+/*
+ * Returns the number of halfmoves since the last capture or pawn move, used for the fifty-move rule.
+ */
+unsigned Board::halfmoveClock() const {
+    return halfmoveClock_;
+}
+
+void Board::setFullmoveNumber(unsigned number) {
+    fullmoveNumber_ = number;
+}
+
+/*
+ * Returns the number of the current move, it starts at 1 and is incremented after every move of black.
+ */
+unsigned Board::fullmoveNumber() const {
+    return fullmoveNumber_;
+}
+
 /*
  * Updates the internal board structure to reflect the given move.
  *
@@ -158,33 +255,48 @@ Square::Optional Board::enPassantSquare() const {
  * legal moves are propagated.
  */
 void Board::makeMove(const Move &move) {
+    // we know that the given move is valid, no need to check for null
+    auto p = piece(move.from()).value();
+
+    if (p.color() == PieceColor::White)
+        makeMove<PieceColor::White>(move, p);
+    else
+        makeMove<PieceColor::Black>(move, p);
+}
+
+/*
+ * Makes the given move of piece `p`, which has color `Us`.
+ */
+template<PieceColor Us>
+void Board::makeMove(const Move &move, const Piece &p) {
+    constexpr bool white = Us == PieceColor::White;
+    constexpr auto castlingRights = white ? CastlingRights::White : CastlingRights::Black;
+    constexpr auto kingside = white ? CastlingRights::WhiteKingside : CastlingRights::BlackKingside;
+    constexpr auto queenside = white ? CastlingRights::WhiteQueenside : CastlingRights::BlackQueenside;
+    constexpr unsigned backRank = white ? 0 : 56;
+    constexpr int up = white ? 8 : -8;
+
     auto from = move.from();
     auto to = move.to();
-    // we know that the given move is valid, no need to check for null
-    auto p = piece(from).value();
+
+    // start recording the piece changes made by this move
+    dirtyPieces_.count = 0;
+
+    // captures and pawn moves are irreversible and reset the halfmove clock
+    bool irreversible = p.type() == PieceType::Pawn || piece(to).has_value();
+
+    // castling rights and en passant square are hashed back in once they are updated
+    hash_ ^= castlingKey(cr_) ^ enPassantKey(enPassantSquare_);
 
     // CASTLING //
     // unset castling rights when piece moved
     if (p.type() == PieceType::King) {
-        if (p.color() == PieceColor::White) {
-            cr_ &= ~CastlingRights::White;
-        } else {
-            cr_ &= ~CastlingRights::Black;
-        }
+        cr_ &= ~castlingRights;
     } else if (p.type() == PieceType::Rook) {
-        if (p.color() == PieceColor::White) {
-            if (from == Square::A1) {
-                cr_ &= ~CastlingRights::WhiteQueenside;
-            } else if (from == Square::H1) {
-                cr_ &= ~CastlingRights::WhiteKingside;
-            }
-        } else {
-            if (from == Square::A8) {
-                cr_ &= ~CastlingRights::BlackQueenside;
-            } else if (from == Square::H8) {
-                cr_ &= ~CastlingRights::BlackKingside;
-            }
-        }
+        if (from.index() == backRank)
+            cr_ &= ~queenside;
+        else if (from.index() == backRank + 7)
+            cr_ &= ~kingside;
     }
 
     // unset castling rights when rook captured
@@ -199,53 +311,34 @@ void Board::makeMove(const Move &move) {
     }
 
     // move rook when castling
-    if (p.type() == PieceType::King) {
-        if (from == Square::E1 && to == Square::G1) {
-            removePiece(Square::H1);
-            setPiece(Square::F1, Piece::WhiteRook);
-        } else if (from == Square::E1 && to == Square::C1) {
-            removePiece(Square::A1);
-            setPiece(Square::D1, Piece::WhiteRook);
-        } else if (from == Square::E8 && to == Square::G8) {
-            removePiece(Square::H8);
-            setPiece(Square::F8, Piece::BlackRook);
-        } else if (from == Square::E8 && to == Square::C8) {
-            removePiece(Square::A8);
-            setPiece(Square::D8, Piece::BlackRook);
+    if (p.type() == PieceType::King && from.index() == backRank + 4) {
+        auto rook = Piece(Us, PieceType::Rook);
+
+        if (to.index() == backRank + 6) {
+            removePiece(Square(backRank + 7));
+            setPiece(Square(backRank + 5), rook);
+        } else if (to.index() == backRank + 2) {
+            removePiece(Square(backRank));
+            setPiece(Square(backRank + 3), rook);
         }
     }
 
     // EN PASSANT //
     // Remove piece after en passant capture
-    if (p.type() == PieceType::Pawn && to == enPassantSquare_) {
-        if (p.color() == PieceColor::White) {
-            removePiece(Square::fromCoordinates(to.file(), to.rank() - 1).value());
-        } else {
-            removePiece(Square::fromCoordinates(to.file(), to.rank() + 1).value());
-        }
-    }
+    if (p.type() == PieceType::Pawn && to == enPassantSquare_)
+        removePiece(Square(to.index() - up));
 
     // Set en passant to null at the end of the turn
     if (enPassantSquare_)
         enPassantSquare_ = std::nullopt;
 
-    // Set en passant flag
-    if (p.type() == PieceType::Pawn) {
-        auto left = piece(Square::fromCoordinates(to.file() - 1, to.rank()));
-        auto right = piece(Square::fromCoordinates(to.file() + 1, to.rank()));
-        if (p.color() == PieceColor::White) {
-            if (from.rank() == 1 && to.rank() == 3 &&
-                ((left.has_value() && left == Piece::BlackPawn) ||
-                 (right.has_value() && right == Piece::BlackPawn))) {
-                enPassantSquare_ = Square::fromCoordinates(to.file(), 2).value();
-            }
-        } else {
-            if (from.rank() == 6 && to.rank() == 4 &&
-                ((left.has_value() && left == Piece::WhitePawn) ||
-                 (right.has_value() && right == Piece::WhitePawn))) {
-                enPassantSquare_ = Square::fromCoordinates(to.file(), 5).value();
-            }
-        }
+    // Set en passant flag when a double pawn push lands next to an enemy pawn
+    if (p.type() == PieceType::Pawn && int(to.index()) - int(from.index()) == 2 * up) {
+        U64 target = bit << to.index();
+        U64 adjacent = ((target << 1) & ~FILE_A) | ((target >> 1) & ~FILE_H);
+
+        if (adjacent & bitboards[white ? 11 : 5])
+            enPassantSquare_ = Square(from.index() + up);
     }
 
     // MOVE PIECE //
@@ -258,24 +351,164 @@ void Board::makeMove(const Move &move) {
     // PROMOTION //
     if (move.promotion()) {
         removePiece(to);
-        setPiece(to, Piece(p.color(), move.promotion().value()));
+        setPiece(to, Piece(Us, move.promotion().value()));
     }
 
+    hash_ ^= castlingKey(cr_) ^ enPassantKey(enPassantSquare_);
+
+    halfmoveClock_ = irreversible ? 0 : halfmoveClock_ + 1;
+
+    if constexpr (Us == PieceColor::Black)
+        fullmoveNumber_++;
+
     // SWITCH TURN //
     turn_ = !turn_;
+    hash_ ^= zobrist.black;
 }
 
 /*
  * Generates all possible pseudo-legal moves for the current board state and puts them in the given vector.
  */
 void Board::pseudoLegalMoves(MoveVec &moves) const {
-    for (int i = 0; i < NSQ; i++) {
-        auto const from = Square::fromIndex(i).value();
+    if (turn_ == PieceColor::White)
+        generateMoves<PieceColor::White>(moves);
+    else
+        generateMoves<PieceColor::Black>(moves);
+}
+
+/*
+ * Adds a move from the given square to every square in `targets`.
+ */
+static void addMoves(const Square &from, U64 targets, Board::MoveVec &moves) {
+    while (targets) {
+        moves.emplace_back(from, Square(std::countr_zero(targets)));
+        targets &= targets - 1;
+    }
+}
+
+/*
+ * Generates all pseudo-legal moves of the color `Us`, which must be the side to move.
+ *
+ * The color is a template parameter so that it is only checked once per node, all offsets and shift directions in
+ * the generation itself are constants.
+ */
+template<PieceColor Us>
+void Board::generateMoves(MoveVec &moves) const {
+    constexpr int offset = Us == PieceColor::White ? 0 : 6;
+
+    U64 empty = getEmptySquares();
+    U64 enemy = getEnemySquares(Us);
+
+    generatePawnMoves<Us>(moves);
+
+    // bitboards are ordered king, queen, rook, bishop, knight, pawn
+    for (U64 pieces = bitboards[offset]; pieces; pieces &= pieces - 1) {
+        auto from = Square(std::countr_zero(pieces));
+        U64 targets = MoveGenerator::kingMoves(*this, from, empty, enemy, false) |
+                      MoveGenerator::castlingMoves<Us>(*this, empty);
+        addMoves(from, targets, moves);
+    }
+
+    for (U64 pieces = bitboards[offset + 1]; pieces; pieces &= pieces - 1) {
+        auto from = Square(std::countr_zero(pieces));
+        addMoves(from, MoveGenerator::queenMoves(from, empty, enemy), moves);
+    }
+
+    for (U64 pieces = bitboards[offset + 2]; pieces; pieces &= pieces - 1) {
+        auto from = Square(std::countr_zero(pieces));
+        addMoves(from, MoveGenerator::rookMoves(from, empty, enemy), moves);
+    }
+
+    for (U64 pieces = bitboards[offset + 3]; pieces; pieces &= pieces - 1) {
+        auto from = Square(std::countr_zero(pieces));
+        addMoves(from, MoveGenerator::bishopMoves(from, empty, enemy), moves);
+    }
+
+    for (U64 pieces = bitboards[offset + 4]; pieces; pieces &= pieces - 1) {
+        auto from = Square(std::countr_zero(pieces));
+        addMoves(from, MoveGenerator::knightMoves(from, empty, enemy), moves);
+    }
+}
+
+/*
+ * Adds a pawn move for every square in `targets`, where the pawn came from the square `offset` squares back.
+ * Moves to the first or last rank are added as the four possible promotions.
+ */
+static void addPawnMoves(U64 targets, int offset, Board::MoveVec &moves) {
+    U64 promotions = targets & (RANK_1 | RANK_8);
+    targets &= ~promotions;
+
+    while (targets) {
+        int to = std::countr_zero(targets);
+        targets &= targets - 1;
+        moves.emplace_back(Square(to - offset), Square(to));
+    }
+
+    while (promotions) {
+        int to = std::countr_zero(promotions);
+        promotions &= promotions - 1;
 
-        pseudoLegalMovesFrom(from, moves);
+        auto from = Square(to - offset);
+        auto square = Square(to);
+        moves.emplace_back(from, square, PieceType::Queen);
+        moves.emplace_back(from, square, PieceType::Rook);
+        moves.emplace_back(from, square, PieceType::Bishop);
+        moves.emplace_back(from, square, PieceType::Knight);
     }
 }
 
+/*
+ * Shifts the given bitboard the given number of ranks forward from the perspective of `Us`.
+ */
+template<PieceColor Us>
+static constexpr U64 forward(U64 bitboard, int shift) {
+    if constexpr (Us == PieceColor::White)
+        return bitboard << shift;
+    else
+        return bitboard >> shift;
+}
+
+/*
+ * Generates all pseudo-legal pawn moves for the current board state and puts them in the given vector.
+ */
+void Board::pseudoLegalPawnMoves(MoveVec &moves) const {
+    if (turn_ == PieceColor::White)
+        generatePawnMoves<PieceColor::White>(moves);
+    else
+        generatePawnMoves<PieceColor::Black>(moves);
+}
+
+/*
+ * Generates all pseudo-legal pawn moves of the color `Us`.
+ *
+ * Instead of generating the moves of every pawn separately, the whole pawn bitboard is shifted once per direction.
+ * Every target square then corresponds to the pawn that is a fixed offset back.
+ *
+ * Source: https://www.chessprogramming.org/Pawn_Pushes_(Bitboards)
+ */
+template<PieceColor Us>
+void Board::generatePawnMoves(MoveVec &moves) const {
+    constexpr bool white = Us == PieceColor::White;
+    constexpr int up = white ? 8 : -8;
+    // captures towards the a-file and towards the h-file
+    constexpr int west = white ? 7 : -9;
+    constexpr int east = white ? 9 : -7;
+    constexpr U64 doublePushRank = white ? RANK_3 : RANK_6;
+
+    U64 empty = getEmptySquares();
+    U64 targets = getEnemySquares(Us);
+    if (enPassantSquare_)
+        targets |= bit << enPassantSquare_->index();
+
+    U64 pawns = bitboards[white ? 5 : 11];
+    U64 pushes = forward<Us>(pawns, 8) & empty;
+
+    addPawnMoves(pushes, up, moves);
+    addPawnMoves(forward<Us>(pushes & doublePushRank, 8) & empty, 2 * up, moves);
+    addPawnMoves(forward<Us>(pawns, white ? 7 : 9) & ~FILE_H & targets, west, moves);
+    addPawnMoves(forward<Us>(pawns, white ? 9 : 7) & ~FILE_A & targets, east, moves);
+}
+
 /*
  * Generates all pseudo-legal moves from the given square on the current board state and puts them in the given vector.
  */
@@ -339,22 +572,14 @@ void Board::pseudoLegalMovesFrom(const Square &from,
  * Returns a bitboard representing all squares that are empty.
  */
 U64 Board::getEmptySquares() const {
-    U64 occupiedSquares = 0UL;
-    for (auto bitboard: bitboards)
-        occupiedSquares |= bitboard;
-
-    return ~occupiedSquares;
+    return ~(occupancy_[0] | occupancy_[1]);
 }
 
 /*
  * Returns a bitboard representing all squares that are occupied by an enemy piece.
  */
 U64 Board::getEnemySquares(PieceColor color) const {
-    U64 enemySquares = 0UL;
-    int offset = color == PieceColor::White ? 6 : 0;
-    for (int i = 0; i < 6; i++)
-        enemySquares |= bitboards[i + offset];
-    return enemySquares;
+    return occupancy_[color == PieceColor::White ? 1 : 0];
 }
 
 
@@ -363,49 +588,113 @@ U64 Board::getEnemySquares(PieceColor color) const {
  * Controlled in this context means that the enemy either already occupies that square or can move to that square in one move.
  */
 U64 Board::getEnemyControlledSquares(PieceColor pieceColor) const {
-    auto offset = pieceColor == PieceColor::White ? 6 : 0;
+    auto enemy = pieceColor == PieceColor::White ? 1 : 0;
+    return attackInfo().attacked[enemy] | getEnemySquares(pieceColor);
+}
 
-    U64 controlled = 0UL;
-    auto enemy = getEnemySquares(!pieceColor);
-    auto empty = getEmptySquares();
+/*
+ * Returns the attack maps of the current board state.
+ *
+ * The attack maps are computed at most once per board state, the first time they are needed. Check detection,
+ * castling, SEE and evaluation all share the same result.
+ */
+const Board::AttackInfo &Board::attackInfo() const {
+    if (!attackInfo_)
+        computeAttackInfo();
 
-    // loop over all enemy bitboards and generate moves for each piece type
-    for (auto i = 0; i < 6; i++) {
-        auto p = bitboardTypes[i + offset];
-        auto bb = bitboards[i + offset];
-
-        controlled |= bb;
-
-        for (auto j = 0; j < NSQ; j++) {
-            if (bb & (bit << j)) {
-                auto square = Square::fromIndex(j).value();
-                switch (p.type()) {
-                    case PieceType::Pawn:
-                        controlled |= MoveGenerator::pawnAttacks(square, !pieceColor);
-                        break;
-                    case PieceType::Knight:
-                        controlled |= MoveGenerator::knightMoves(square, empty, enemy);
-                        break;
-                    case PieceType::Bishop:
-                        controlled |= MoveGenerator::bishopMoves(square, empty, enemy);
-                        break;
-                    case PieceType::Rook:
-                        controlled |= MoveGenerator::rookMoves(square, empty, enemy);
-                        break;
-                    case PieceType::Queen:
-                        controlled |= MoveGenerator::queenMoves(square, empty, enemy);
-                        break;
-                    case PieceType::King:
-                        // since castling does not contribute to the controlled squares,
-                        // we can set the `allowCastling` parameter to `false` to save some moves
-                        controlled |= MoveGenerator::kingMoves(*this, square, empty, enemy, false);
-                        break;
-                }
-            }
+    return *attackInfo_;
+}
+
+/*
+ * Returns the squares strictly between the given squares, which must be on the same rank, file or diagonal.
+ */
+static U64 between(const Square &a, const Square &b) {
+    U64 occupied = (bit << a.index()) | (bit << b.index());
+
+    // the attacks of both squares, blocked by each other, only overlap on the line between them
+    if (a.rank() == b.rank() || a.file() == b.file())
+        return MoveGenerator::rookMoves(a, ~occupied, occupied) & MoveGenerator::rookMoves(b, ~occupied, occupied);
+
+    return MoveGenerator::bishopMoves(a, ~occupied, occupied) & MoveGenerator::bishopMoves(b, ~occupied, occupied);
+}
+
+void Board::computeAttackInfo() const {
+    AttackInfo info{};
+    U64 occupied = ~getEmptySquares();
+    U64 empty = ~occupied;
+
+    // all pieces except the kings are handled set-wise, for both colors at once
+    U64 rooks[2] = {bitboards[2], bitboards[8]};
+    U64 bishops[2] = {bitboards[3], bitboards[9]};
+    U64 queens[2] = {bitboards[1], bitboards[7]};
+    U64 straight[2], diagonal[2];
+
+    MoveGenerator::slidingAttacks(rooks, bishops, empty, straight, diagonal);
+    info.attacks[2] = straight[0];
+    info.attacks[3] = diagonal[0];
+    info.attacks[8] = straight[1];
+    info.attacks[9] = diagonal[1];
+
+    MoveGenerator::slidingAttacks(queens, queens, empty, straight, diagonal);
+    info.attacks[1] = straight[0] | diagonal[0];
+    info.attacks[7] = straight[1] | diagonal[1];
+
+    info.attacks[4] = MoveGenerator::knightAttacks(bitboards[4]);
+    info.attacks[10] = MoveGenerator::knightAttacks(bitboards[10]);
+    info.attacks[5] = ((bitboards[5] << 9) & ~FILE_A) | ((bitboards[5] << 7) & ~FILE_H);
+    info.attacks[11] = ((bitboards[11] >> 7) & ~FILE_A) | ((bitboards[11] >> 9) & ~FILE_H);
+
+    for (int i = 0; i < NBB; i += 6) {
+        if (bitboards[i]) {
+            auto square = Square(std::countr_zero(bitboards[i]));
+            info.attacks[i] = MoveGenerator::kingMoves(*this, square, ~0UL, 0UL, false);
         }
     }
 
-    return controlled;
+    for (int i = 0; i < NBB; i++)
+        info.attacked[i / 6] |= info.attacks[i];
+
+    computeKingThreats<PieceColor::White>(info, occupied);
+    computeKingThreats<PieceColor::Black>(info, occupied);
+
+    attackInfo_ = info;
+}
+
+/*
+ * Fills in the pieces that give check to the king of color `Us` and the pieces that are pinned to it.
+ */
+template<PieceColor Us>
+void Board::computeKingThreats(AttackInfo &info, U64 occupied) const {
+    constexpr int color = Us == PieceColor::White ? 0 : 1;
+    constexpr int offset = color * 6;
+    constexpr int enemyOffset = 6 - offset;
+
+    U64 king = bitboards[offset];
+    if (!king)
+        return;
+
+    auto kingSquare = Square(std::countr_zero(king));
+    U64 own = getEnemySquares(!Us);
+    U64 enemy = occupied & ~own;
+
+    info.checkers[color] = attackersTo(kingSquare, occupied) & enemy;
+
+    // enemy sliders that would attack the king on an empty board pin a piece if exactly one piece is in between
+    U64 snipers = (MoveGenerator::rookMoves(kingSquare, ~0UL, 0UL) &
+                   (bitboards[enemyOffset + 1] | bitboards[enemyOffset + 2])) |
+                  (MoveGenerator::bishopMoves(kingSquare, ~0UL, 0UL) &
+                   (bitboards[enemyOffset + 1] | bitboards[enemyOffset + 3]));
+
+    while (snipers) {
+        auto sniper = Square(std::countr_zero(snipers));
+        snipers &= snipers - 1;
+
+        U64 blockers = between(kingSquare, sniper) & occupied;
+        if (blockers && !(blockers & (blockers - 1)) && (blockers & own)) {
+            info.pinned[color] |= blockers;
+            info.pinners[color] |= bit << sniper.index();
+        }
+    }
 }
 
 /*
@@ -440,15 +729,12 @@ std::string Board::toString() const {
     };
 
 
-    // iterate over bitboards, check which squares are set
-    for (int i = 0; i < NBB; i++) {
-        auto bb = bitboards[i];
-        for (int j = 0; j < NSQ; j++) {
-            if (bb & (bit << j)) { // check if it is occupied
-                auto row = j / 8;
-                auto col = j % 8;
-                board[row][col] = bitboardTypes[i].toSymbol();
-            }
+    // iterate over the squares, check which ones are occupied
+    for (int j = 0; j < NSQ; j++) {
+        if (auto p = mailbox_[j]) {
+            auto row = j / 8;
+            auto col = j % 8;
+            board[row][col] = p->toSymbol();
         }
     }
 
@@ -484,7 +770,7 @@ Board::MoveVec Board::generateMovesFromBitboard(const Square &from, const U64 &b
     MoveVec moves;
     for (int i = 0; i < NSQ; i++) {
         if (bitboard & (bit << i)) {
-            auto to = Square::fromIndex(i).value();
+            auto to = Square(i);
             auto move = Move(from, to);
             moves.push_back(move);
         }
@@ -514,126 +800,312 @@ const Piece Board::bitboardTypes[12] = {
         Piece(PieceColor::Black, PieceType::Pawn)
 };
 
+std::string Board::INITIAL_BOARD_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
 /*
- * Maps a piece type to the corresponding bitboard index.
- */
-const std::map<Piece, int> Board::bitboardMap = {
-        {Piece(PieceColor::White, PieceType::King),   0},
-        {Piece(PieceColor::White, PieceType::Queen),  1},
-        {Piece(PieceColor::White, PieceType::Rook),   2},
-        {Piece(PieceColor::White, PieceType::Bishop), 3},
-        {Piece(PieceColor::White, PieceType::Knight), 4},
-        {Piece(PieceColor::White, PieceType::Pawn),   5},
-        {Piece(PieceColor::Black, PieceType::King),   6},
-        {Piece(PieceColor::Black, PieceType::Queen),  7},
-        {Piece(PieceColor::Black, PieceType::Rook),   8},
-        {Piece(PieceColor::Black, PieceType::Bishop), 9},
-        {Piece(PieceColor::Black, PieceType::Knight), 10},
-        {Piece(PieceColor::Black, PieceType::Pawn),   11}
-};
+ * Generates the pseudo-legal moves that don't leave the king of the side to move in check.
+ */
+void Board::legalMoves(MoveVec &moves) const {
+    MoveVec pseudoLegal;
+    pseudoLegalMoves(pseudoLegal);
 
-std::string Board::INITIAL_BOARD_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    for (auto m : pseudoLegal) {
+        if (isLegal(m))
+            moves.push_back(m);
+    }
+}
 
 /*
- * Checks whether the given color is in check for the current board state.
+ * Checks whether the given squares are on one line, i.e. the same rank, file or diagonal when two of them are known to
+ * be on one.
  */
-bool Board::isCheck(PieceColor c) const {
-    U64 enemyControlled = getEnemyControlledSquares(c);
-    auto offset = c == PieceColor::White ? 0 : 6;
-    auto king = bitboards[0 + offset];
-    return enemyControlled & king;
+static bool aligned(const Square &a, const Square &b, const Square &c) {
+    int fileB = int(b.file()) - int(a.file()), rankB = int(b.rank()) - int(a.rank());
+    int fileC = int(c.file()) - int(a.file()), rankC = int(c.rank()) - int(a.rank());
+    return fileB * rankC == fileC * rankB;
 }
 
 /*
- * Checks whether the given color is in checkmate for the current board state.
+ * Checks whether the given pseudo-legal move of the side to move doesn't leave its own king in check.
+ *
+ * The checkers and pins of the attack maps of this board are used, so the move doesn't have to be played:
+ *  - the king may not move to an attacked square, sliders see through the square it leaves
+ *  - when in double check only the king can move, a single check must be captured or blocked
+ *  - a pinned piece may only move along the line through its king and the pinner
+ * Only en passant, which removes two pieces from a rank at once, is played to check it.
  */
-bool Board::isCheckMate(PieceColor c) const {
+bool Board::isLegal(const Move &move) const {
+    int color = turn_ == PieceColor::White ? 0 : 1;
+    U64 king = bitboards[color * 6];
 
-    // color can't be in checkmate if it is not in check
-    if (!isCheck(c))
-        return false;
+    // positions without a king, as used in tests
+    if (!king)
+        return true;
 
-    std::vector<Move> moves;
-    pseudoLegalMoves(moves);
-    for (auto m : moves) {
+    auto kingSquare = Square(std::countr_zero(king));
+    U64 from = bit << move.from().index();
+    U64 to = bit << move.to().index();
+    U64 enemy = getEnemySquares(turn_);
+
+    if (from == king) {
+        // castling moves are only generated when the king doesn't pass through an attacked square
+        if (std::abs(int(move.from().file()) - int(move.to().file())) == 2)
+            return true;
+
+        return !(attackersTo(move.to(), ~getEmptySquares() ^ from) & enemy);
+    }
+
+    bool enPassant = (bitboards[color * 6 + 5] & from) && move.to() == enPassantSquare_ &&
+                     move.from().file() != move.to().file();
+
+    if (enPassant) {
         auto newBoard = *this;
-        newBoard.makeMove(m);
-        // if the color is not in check after the move, it is not checkmate
-        if (!newBoard.isCheck(c)){
+        newBoard.makeMove(move);
+        return !newBoard.isCheck(turn_);
+    }
+
+    auto &info = attackInfo();
+    U64 checkers = info.checkers[color];
+
+    if (checkers) {
+        if (checkers & (checkers - 1))
+            return false;
+
+        auto checker = Square(std::countr_zero(checkers));
+        if (!(to & (checkers | between(kingSquare, checker))))
             return false;
-        }
     }
 
-    // if there are no moves that remove the check, it is checkmate
+    if (from & info.pinned[color])
+        return aligned(kingSquare, move.from(), move.to());
+
     return true;
 }
 
+/*
+ * Checks whether the given color is in check for the current board state.
+ */
+bool Board::isCheck(PieceColor c) const {
+    return attackInfo().checkers[c == PieceColor::White ? 0 : 1];
+}
+
+/*
+ * Checks whether the side to move has at least one legal move, using the pins and checkers of this board so that no
+ * move has to be played.
+ */
+bool Board::hasLegalMove() const {
+    MoveVec moves;
+    pseudoLegalMoves(moves);
+
+    return std::any_of(moves.begin(), moves.end(), [this](const Move &m) {
+        return isLegal(m);
+    });
+}
+
+/*
+ * Checks whether the given color is in checkmate for the current board state. Only the side to move can be mated.
+ */
+bool Board::isCheckMate(PieceColor c) const {
+    return c == turn_ && isCheck(c) && !hasLegalMove();
+}
+
+/*
+ * Checks whether the given color is in stalemate for the current board state. Only the side to move can be stalemated.
+ */
 bool Board::isStaleMate(PieceColor c) const {
+    return c == turn_ && !isCheck(c) && !hasLegalMove();
+}
 
-    // color can't be stalemate if it is in check
-    if (isCheck(c))
+const std::array<U64, 12> &Board::getBitboards() const {
+    return bitboards;
+}
+
+/*
+ * Returns a bitboard of all pieces, of both colors, that attack the given square when the squares in `occupied` are
+ * occupied. Passing a custom occupancy makes it possible to discover x-ray attackers behind pieces that were removed.
+ */
+U64 Board::attackersTo(const Square &square, U64 occupied) const {
+    auto empty = ~occupied;
+
+    // attacks are symmetric: a piece on `square` attacks exactly the squares from which a piece of the same type
+    // attacks `square`, only pawns need the attacks of the opposite color
+    U64 bishops = MoveGenerator::bishopMoves(square, empty, occupied);
+    U64 rooks = MoveGenerator::rookMoves(square, empty, occupied);
+    U64 knights = MoveGenerator::knightMoves(square, ~0UL, 0UL);
+    U64 kings = MoveGenerator::kingMoves(*this, square, ~0UL, 0UL, false);
+
+    return (MoveGenerator::pawnAttacks(square, PieceColor::Black) & bitboards[5]) |
+           (MoveGenerator::pawnAttacks(square, PieceColor::White) & bitboards[11]) |
+           (knights & (bitboards[4] | bitboards[10])) |
+           (bishops & (bitboards[1] | bitboards[3] | bitboards[7] | bitboards[9])) |
+           (rooks & (bitboards[1] | bitboards[2] | bitboards[7] | bitboards[8])) |
+           (kings & (bitboards[0] | bitboards[6]));
+}
+
+/*
+ * Static Exchange Evaluation.
+ *
+ * Returns whether the sequence of captures on the destination square of the given move gains at least `threshold`
+ * centipawns for the side to move, assuming both sides always recapture with their least valuable attacker and may
+ * stop capturing whenever that is better for them. Sliders that are hidden behind a capturing piece (x-rays) join
+ * the exchange as soon as that piece has moved.
+ *
+ * Source: https://www.chessprogramming.org/SEE_-_The_Swap_Algorithm
+ */
+bool Board::see(const Move &move, int threshold) const {
+    auto from = move.from();
+    auto to = move.to();
+
+    // promotions and castling are never considered losing
+    if (move.promotion())
+        return threshold <= 0;
+
+    auto attacker = piece(from);
+    if (!attacker || (attacker->type() == PieceType::King && std::abs(int(to.file()) - int(from.file())) == 2))
+        return threshold <= 0;
+
+    auto victim = piece(to);
+    bool enPassant = attacker->type() == PieceType::Pawn && to == enPassantSquare_;
+
+    // the gain if the opponent does not recapture
+    int swap = (victim ? victim->value() : (enPassant ? Piece::WhitePawn.value() : 0)) - threshold;
+    if (swap < 0)
         return false;
 
-    std::vector<Move> moves;
-    pseudoLegalMoves(moves);
-    for (auto m : moves) {
-        auto newBoard = *this;
-        newBoard.makeMove(m);
-        // if the color is not in check after the move, it is not checkmate
-        if (!newBoard.isCheck(c)){
-            return false;
+    // the gain if the opponent recaptures and we stop afterwards
+    swap = attacker->value() - swap;
+    if (swap <= 0)
+        return true;
+
+    U64 occupied = ~getEmptySquares() ^ (bit << from.index()) ^ (bit << to.index());
+    if (enPassant)
+        occupied ^= bit << (turn_ == PieceColor::White ? to.index() - 8 : to.index() + 8);
+
+    U64 attackers = attackersTo(to, occupied);
+    U64 diagonal = bitboards[1] | bitboards[3] | bitboards[7] | bitboards[9];
+    U64 straight = bitboards[1] | bitboards[2] | bitboards[7] | bitboards[8];
+    U64 white = getEnemySquares(PieceColor::Black);
+    U64 black = getEnemySquares(PieceColor::White);
+
+    auto &info = attackInfo();
+    auto stm = turn_;
+    bool result = true;
+
+    while (true) {
+        stm = !stm;
+        attackers &= occupied;
+
+        // the least valuable attacker of the side to move captures next
+        auto offset = stm == PieceColor::White ? 0 : 6;
+        U64 stmAttackers = attackers & (stm == PieceColor::White ? white : black);
+
+        // pinned pieces can't join the exchange as long as their pinner is still on the board
+        auto color = stm == PieceColor::White ? 0 : 1;
+        if (info.pinners[color] & occupied)
+            stmAttackers &= ~info.pinned[color];
+
+        if (!stmAttackers)
+            break;
+
+        result = !result;
+
+        // bitboards are ordered king, queen, rook, bishop, knight, pawn, so go from pawn to king
+        int i = 5;
+        while (!(stmAttackers & bitboards[i + offset]))
+            i--;
+
+        if (i == 0) {
+            // a king can only capture if the opponent has no attackers left, pinned pieces of the king's own side
+            // don't defend the square for the opponent
+            return (attackers & (stm == PieceColor::White ? black : white)) ? !result : result;
         }
-    }
 
-    // if there are no moves that remove the check, it is checkmate
-    return true;
-}
+        swap = bitboardTypes[i].value() - swap;
+        if (swap < result)
+            break;
 
-std::vector<U64> Board::getBitboards() const {
-    return bitboards;
+        // remove the attacker and add the x-ray attackers that were behind it
+        occupied ^= bit << std::countr_zero(stmAttackers & bitboards[i + offset]);
+        if (i == 5 || i == 3 || i == 1)
+            attackers |= MoveGenerator::bishopMoves(to, ~occupied, occupied) & diagonal;
+        if (i == 2 || i == 1)
+            attackers |= MoveGenerator::rookMoves(to, ~occupied, occupied) & straight;
+    }
+
+    return result;
 }
 
+/*
+ * Returns a score used to order the given move, higher scores are searched first.
+ *
+ * Captures that do not lose material according to SEE come first, most valuable victim first. Captures that lose
+ * material are searched after all quiet moves.
+ */
 int Board::moveScore(const Move &move) const {
     auto p = piece(move.to());
-    if (p)
-        return p->value();
-    else
+    if (!p)
         return 0;
+
+    if (see(move, 0))
+        return GOOD_CAPTURE_SCORE + p->value();
+    else
+        return p->value() - GOOD_CAPTURE_SCORE;
 }
 
 bool Board::compareMoves(const Move &lhs, const Move &rhs) const {
     return moveScore(lhs) > moveScore(rhs);
 }
 
-void Board::initHashKeys() {
-    for (auto & row : hashTable) {
-        for (unsigned long & el : row) {
-            el = randLong();
-        }
-    }
+/*
+ * Returns the Zobrist hash of the current board state.
+ *
+ * The hash is maintained incrementally by every function that modifies the board, so this is a simple lookup.
+ */
+U64 Board::hash() const {
+    return hash_;
+}
 
-    blackHash = randLong();
+/*
+ * Returns the material and piece-square score of all pieces on the board, from the perspective of white.
+ */
+Score Board::pieceSquareScore() const {
+    return pieceSquareScore_;
 }
 
-U64 Board::hash() const {
-    U64 h = 0;
-    if (turn_ == PieceColor::Black)
-        h ^= blackHash;
+/*
+ * Returns the game phase of the board, which is the starting phase when all pieces are on the board and goes down to 0
+ * when only kings and pawns are left.
+ */
+int Board::phase() const {
+    return phase_;
+}
 
-    for (int i = 0; i < NSQ; i++) {
-        auto p = piece(i);
-        if (p)
-            h ^= hashTable[i][bitboardMap.at(p.value())];
+/*
+ * Returns the pieces that were added and removed by the last move.
+ */
+const Board::DirtyPieces &Board::dirtyPieces() const {
+    return dirtyPieces_;
+}
+
+/*
+ * Records a piece change made by the current move. If more changes are made than fit in the record, it is marked as
+ * unknown.
+ */
+void Board::recordChange(int bitboard, unsigned int square, bool added) {
+    if (dirtyPieces_.count < 0)
+        return;
+
+    if (dirtyPieces_.count == DirtyPieces::MAX_CHANGES) {
+        dirtyPieces_.count = -1;
+        return;
     }
 
-    return h;
+    dirtyPieces_.changes[dirtyPieces_.count++] = {bitboard, square, added};
 }
 
 /*
- * Returns a random 64-bit integer.
+ * Returns the Zobrist hash of the pawns on the board, ignoring all other pieces, the turn and the castling rights.
  */
-U64 Board::randLong() {
-    std::default_random_engine generator;
-    std::uniform_int_distribution<U64> distribution(0, std::numeric_limits<U64>::max());
-    return distribution(generator);
+U64 Board::pawnHash() const {
+    return pawnHash_;
 }
@@ -6,11 +6,12 @@
 #include "Move.hpp"
 #include "CastlingRights.hpp"
 #include "Piece.hpp"
+#include "Score.hpp"
 
 #include <optional>
 #include <iosfwd>
 #include <vector>
-#include <map>
+#include <array>
 #include <bitset>
 #include <memory>
 
@@ -21,6 +22,38 @@ public:
     using MoveVec = std::vector<Move>;
     using U64 = uint64_t;
 
+    /*
+     * A piece that was added to or removed from a square.
+     */
+    struct PieceChange {
+        int bitboard;
+        unsigned square;
+        bool added;
+    };
+
+    /*
+     * All piece changes made by the last move, used to update evaluation state incrementally.
+     * A count of -1 means that the changes are unknown, e.g., because the board was not created by making a move.
+     */
+    struct DirtyPieces {
+        static constexpr int MAX_CHANGES = 6;
+
+        int count = -1;
+        PieceChange changes[MAX_CHANGES];
+    };
+
+    /*
+     * Attack maps of a board state, indexed by bitboard or by color (white 0, black 1).
+     * Sliders attack up to and including the first piece on each ray, regardless of its color.
+     */
+    struct AttackInfo {
+        U64 attacks[12];  // squares attacked by the pieces of each bitboard
+        U64 attacked[2];  // squares attacked by each color
+        U64 checkers[2];  // enemy pieces that give check to the king of each color
+        U64 pinned[2];    // pieces of each color that are pinned to their own king
+        U64 pinners[2];   // enemy sliders that pin a piece of each color
+    };
+
     Board();
 
     void setPiece(const Square &square, const Piece::Optional &piece);
@@ -45,12 +78,26 @@ public:
 
     [[nodiscard]] Square::Optional enPassantSquare() const;
 
+    void setHalfmoveClock(unsigned clock);
+
+    [[nodiscard]] unsigned halfmoveClock() const;
+
+    void setFullmoveNumber(unsigned number);
+
+    [[nodiscard]] unsigned fullmoveNumber() const;
+
     void makeMove(const Move &move);
 
     void pseudoLegalMoves(MoveVec &moves) const;
 
     void pseudoLegalMovesFrom(const Square &from, MoveVec &moves) const;
 
+    void pseudoLegalPawnMoves(MoveVec &moves) const;
+
+    void legalMoves(MoveVec &moves) const;
+
+    [[nodiscard]] bool isLegal(const Move &move) const;
+
     [[nodiscard]] std::string toString() const;
 
 //    [[nodiscard]] Board copy() const;
@@ -78,17 +125,27 @@ public:
 
     static const Piece bitboardTypes[12];
 
-    [[nodiscard]] std::vector<U64> getBitboards() const;
+    [[nodiscard]] const std::array<U64, 12> &getBitboards() const;
+
+    [[nodiscard]] const AttackInfo &attackInfo() const;
+
+    [[nodiscard]] U64 attackersTo(const Square &square, U64 occupied) const;
+
+    [[nodiscard]] bool see(const Move &move, int threshold) const;
 
     [[nodiscard]] int moveScore(const Move &move) const;
 
     [[nodiscard]] bool compareMoves(const Move &lhs, const Move &rhs) const;
 
-    void initHashKeys();
-
     [[nodiscard]] U64 hash() const;
 
-    static U64 randLong();
+    [[nodiscard]] U64 pawnHash() const;
+
+    [[nodiscard]] Score pieceSquareScore() const;
+
+    [[nodiscard]] int phase() const;
+
+    [[nodiscard]] const DirtyPieces &dirtyPieces() const;
 
     [[nodiscard]] bool isNewGame() const;
 
@@ -96,15 +153,52 @@ private:
     PieceColor turn_;
     CastlingRights cr_;
     std::optional<Square> enPassantSquare_ = std::nullopt;
+    unsigned halfmoveClock_ = 0;
+    unsigned fullmoveNumber_ = 1;
     bool promotion = false;
 
-    static const std::map<Piece, int> bitboardMap;
+    std::array<U64, 12> bitboards{};
+
+    // the piece on every square, kept in sync with the bitboards
+    std::array<Piece::Optional, 64> mailbox_{};
+
+    // all pieces of each color (white 0, black 1), kept in sync with the bitboards
+    U64 occupancy_[2] = {0UL, 0UL};
+
+    // Zobrist hash of the current board state, updated incrementally
+    U64 hash_ = 0;
+
+    // Zobrist hash of only the pawns, used to cache the pawn structure evaluation
+    U64 pawnHash_ = 0;
+
+    // material and piece-square score of all pieces on the board, updated incrementally
+    Score pieceSquareScore_ = 0;
+
+    // game phase based on the material on the board, updated incrementally
+    int phase_ = 0;
+
+    DirtyPieces dirtyPieces_;
+
+    // attack maps of the current board state, computed when first needed and reset whenever a piece changes
+    mutable std::optional<AttackInfo> attackInfo_;
+
+    void recordChange(int bitboard, unsigned square, bool added);
+
+    template<PieceColor Us>
+    void makeMove(const Move &move, const Piece &p);
+
+    template<PieceColor Us>
+    void generateMoves(MoveVec &moves) const;
+
+    template<PieceColor Us>
+    void generatePawnMoves(MoveVec &moves) const;
 
-    std::vector<U64> bitboards;
+    template<PieceColor Us>
+    void computeKingThreats(AttackInfo &info, U64 occupied) const;
 
-    U64 hashTable[64][12] = {};
+    void computeAttackInfo() const;
 
-    U64 blackHash = 0;
+    [[nodiscard]] bool hasLegalMove() const;
 };
 
 std::ostream &operator<<(std::ostream &os, const Board &board);
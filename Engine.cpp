@@ -1,12 +1,21 @@
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <queue>
 #include <algorithm>
 #include "Engine.hpp"
 #include "Fen.hpp"
 #include "Evaluate.h"
+#include "Nnue.hpp"
 
-#define DEPTH 11 // maximum depth of search
+#define DEPTH 11 // maximum depth of search when playing on a clock
+#define DEFAULT_DEPTH 7 // depth of a search without limits
+#define MAX_DEPTH 64 // maximum depth that can be requested with a depth limit
+#define LIMIT_CHECK_INTERVAL 1024 // number of nodes between two checks of the clock
+#define HARD_TIME_FACTOR 3 // a search on a clock is aborted after this many times the time for the move
+#define SEE_PRUNING_DEPTH 2 // maximum remaining depth at which losing captures are pruned
+#define SEE_PRUNING_MARGIN 100 // material a capture may lose per remaining ply before it is pruned
+#define CURRMOVE_DELAY 1000 // milliseconds after the start of a search before the root moves are reported
 
 std::optional<HashInfo> Engine::hashInfo() const {
     return std::nullopt;
@@ -14,10 +23,28 @@ std::optional<HashInfo> Engine::hashInfo() const {
 
 void Engine::setHashSize(std::size_t) {}
 
+void Engine::setGameHistory(const std::vector<Board::U64> &) {}
+
+bool Engine::setEvalFile(const std::string &) {
+    return false;
+}
+
+bool Engine::setMultiPv(int) {
+    return false;
+}
+
+std::optional<SearchStatistics> Engine::statistics() const {
+    return std::nullopt;
+}
+
+void Engine::setSearchListener(SearchListener *) {}
+
 /*
  * Returns the principal variation of the current board state.
  */
-PrincipalVariation ChessEngine::pv(const Board &board, const TimeInfo::Optional &timeInfo) {
+PrincipalVariation ChessEngine::pv(const Board &board, const SearchLimits &limits) {
+    statistics_ = std::nullopt;
+
     if (board.isCheckMate(board.turn()))
         return {{}, board.turn(), 0, true};
 
@@ -42,78 +69,178 @@ PrincipalVariation ChessEngine::pv(const Board &board, const TimeInfo::Optional
         }
     }
 
+    nodes_ = 0;
+    Evaluate::resetStatistics();
+    searchStart_ = std::chrono::steady_clock::now();
+
     // perform iterative deepening
-    auto PV = iterativeDeepening(board, timeInfo);
+    auto PV = iterativeDeepening(board, limits);
 
-//    // add board state to map of board states
-//    auto newBoard = board.copy();
-//    newBoard.makeMove(PV.moves_[0]);
-//    if (boardStates.contains(newBoard.hash()))
-//        boardStates[newBoard.hash()]++;
-//    else
-//        boardStates[newBoard.hash()] = 1;
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart_);
+    auto evalStatistics = Evaluate::statistics();
+    statistics_ = {nodes_, evalStatistics.evaluations, evalStatistics.cacheHits, elapsed};
 
     return PV;
 }
 
+/*
+ * Returns the statistics of the last search.
+ */
+std::optional<SearchStatistics> ChessEngine::statistics() const {
+    return statistics_;
+}
+
+/*
+ * Sets the listener that receives the progress of the following searches, nullptr disables the reports.
+ */
+void ChessEngine::setSearchListener(SearchListener *listener) {
+    listener_ = listener;
+}
+
+static std::vector<Move> lineMoves(const LINE &line) {
+    return {line.argmove, line.argmove + line.cMove};
+}
+
 /*
  * Returns a principal variation for the given board, this is done by using iterative deepening.
  *
- * ID starts at depth 1 and increases the depth until the maximum depth (DEPTH) is reached. This function returns early
- * when a checkmate is found, this to prevent unnecessary searching.
+ * ID starts at depth 1 and increases the depth until the depth limit is reached, which is DEPTH when playing on a clock
+ * and DEFAULT_DEPTH when no limit is given. This function returns early when a checkmate is found, this to prevent
+ * unnecessary searching. Every completed iteration is reported to the search listener.
+ *
+ * In MultiPV mode, every iteration searches the root once per line, excluding the first moves of the earlier lines. The
+ * lines share the evaluation cache, and the returned PV is the best line.
+ *
+ * Node and time limits and the stop signal abort the running iteration, in which case the PV of the last completed
+ * iteration is returned. On a clock, no new iteration is started once half of the time for the move is used.
  *
- * TODO: implement time management
+ * A pondering search ignores its limits until the ponder hit signal is received, from then on the time limits are
+ * measured. Pondering and infinite searches only end when stopped, or when they run out of depth.
  */
-PrincipalVariation ChessEngine::iterativeDeepening(const Board &board, const TimeInfo::Optional &timeInfo) {
+PrincipalVariation ChessEngine::iterativeDeepening(const Board &board, const SearchLimits &limits) {
     LINE out;
-    int maxDepth = DEPTH;
     bool mate = false;
     int color = board.turn() == PieceColor::White ? 1 : -1;
     long score = INT32_MIN;
 
-    std::chrono::milliseconds time = moveTime(board.turn(), timeInfo.value());
-    bool timeOut = false;
-
-    // set depth to 7 if no time info is given
-    if (!timeInfo.has_value())
-        maxDepth = 7;
+    int maxDepth = limits.timeInfo ? DEPTH : DEFAULT_DEPTH;
+    if (limits.depth)
+        maxDepth = std::clamp(*limits.depth, 1, MAX_DEPTH);
+    else if (limits.nodes || limits.moveTime)
+        maxDepth = MAX_DEPTH;
+
+    // a mate in n moves is found within 2n - 1 plies
+    if (limits.mate)
+        maxDepth = std::clamp(2 * *limits.mate - 1, 1, maxDepth);
+
+    limits_ = limits;
+    limitsArmed_ = false;
+    stopped_ = false;
+
+    limitStart_ = std::nullopt;
+    if (!limits.ponder)
+        limitStart_ = searchStart_;
+
+    hardTimeLimit_ = limits.moveTime;
+    if (!limits.moveTime && limits.timeInfo)
+        hardTimeLimit_ = HARD_TIME_FACTOR * moveTime(board.turn(), *limits.timeInfo);
+
+    for (int i = 1; i <= MAX_DEPTH; i++) {
+        excludedRootMoves_.clear();
+
+        for (int k = 1; k <= multiPv_; k++) {
+            keyStack_ = gameHistory_;
+            accumulators_.reset();
+            selDepth_ = 0;
+
+            LINE line;
+            long newScore = negamax(board, i, 0, -std::numeric_limits<long>::max(), std::numeric_limits<long>::max(),
+                                    color, &line);
+
+            // a limit was reached during this line, its result is incomplete
+            if (stopped_)
+                break;
+
+            // every root move is already the first move of an earlier line
+            if (line.cMove == 0)
+                break;
+
+            bool lineMate = newScore == INT32_MAX;
+            long lineScore = lineMate ? i : newScore;
+            excludedRootMoves_.push_back(line.argmove[0]);
+
+            if (k == 1) {
+                // found checkmate, stop looking further after this iteration
+                mate = lineMate;
+                score = lineScore;
+                memcpy(&out, &line, sizeof(LINE));
+            }
+
+            if (listener_) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - searchStart_);
+                PrincipalVariation pv(lineMoves(line), board.turn(), lineScore, lineMate);
+                listener_->iterationCompleted({i, selDepth_, k, pv, nodes_, elapsed, Evaluate::cacheUsage()});
+            }
+        }
 
-    for (int i = 1; i <= maxDepth; i++) {
-        if (timeOut)
+        if (stopped_ || mate)
             break;
 
-        LINE line;
-        long newScore;
-        if (timeInfo) {
-            auto start = std::chrono::high_resolution_clock::now();
-            newScore = negamax(board, i, 0, -INT64_MAX, INT64_MAX, color, &line);
-            auto end = std::chrono::high_resolution_clock::now();
-            std::chrono::milliseconds elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-
-            // if the elapsed time for previous iteration is greater than 50% of the time left, return the previous PV
-            if (elapsed > 0.5 * time)
-                timeOut = true;
-        } else {
-            newScore = negamax(board, i, 0, -INT64_MAX, INT64_MAX, color, &line);
-        }
+        // the limits are armed once there is a move to play
+        limitsArmed_ = true;
+
+        if (limits.infinite || isPondering())
+            continue;
 
-        // found checkmate, stop looking further
-        if (newScore == INT32_MAX) {
-            score = i;
-            memcpy(&out, &line, sizeof(LINE));
-            mate = true;
+        if (i >= maxDepth)
             break;
-        }
 
-        score = newScore;
-        memcpy(&out, &line, sizeof(LINE));
+        // if the elapsed time is greater than 50% of the time for the move, the next iteration won't finish in time
+        if (limits.timeInfo &&
+            std::chrono::steady_clock::now() - *limitStart_ > 0.5 * moveTime(board.turn(), *limits.timeInfo))
+            break;
     }
 
-    std::vector<Move> moves;
-    for (int i = 0; i < out.cMove; i++)
-        moves.push_back(out.argmove[i]);
+    // the signals belong to the caller, they are not used after the search
+    limits_ = SearchLimits();
+
+    return {lineMoves(out), board.turn(), score, mate};
+}
 
-    return {moves, board.turn(), score, mate};
+/*
+ * Checks whether the current search has to stop because it was stopped or because its node or time limit is reached.
+ * Reading the clock is relatively expensive, so it is only read every LIMIT_CHECK_INTERVAL nodes.
+ */
+bool ChessEngine::limitReached() {
+    if (!limitsArmed_)
+        return false;
+
+    if (limits_.signals && limits_.signals->stop.load(std::memory_order_relaxed))
+        return true;
+
+    if (limits_.infinite || isPondering())
+        return false;
+
+    if (limits_.nodes && nodes_ >= *limits_.nodes)
+        return true;
+
+    return hardTimeLimit_ && nodes_ % LIMIT_CHECK_INTERVAL == 0 &&
+           std::chrono::steady_clock::now() - *limitStart_ >= *hardTimeLimit_;
+}
+
+/*
+ * Checks whether the current search is still pondering. The time limits start when the ponder hit is first noticed.
+ */
+bool ChessEngine::isPondering() {
+    if (limitStart_)
+        return false;
+
+    if (!limits_.signals || !limits_.signals->ponderHit.load(std::memory_order_relaxed))
+        return true;
+
+    limitStart_ = std::chrono::steady_clock::now();
+    return false;
 }
 
 /*
@@ -134,46 +261,89 @@ PrincipalVariation ChessEngine::iterativeDeepening(const Board &board, const Tim
 long ChessEngine::negamax(const Board &board, int depth, int ply, long alpha, long beta, int color, LINE *pline) {
     LINE line;
 
+    if (stopped_ || limitReached()) {
+        stopped_ = true;
+        pline->cMove = 0;
+        return 0;
+    }
+
+    nodes_++;
+    selDepth_ = std::max(selDepth_, ply);
+
+    // a repetition or a fifty-move draw ends the game, there is no need to search any further
+    if (ply > 0 && isDraw(board)) {
+        pline->cMove = 0;
+        return 0;
+    }
+
     // reached maximum depth, return the score of the current board state
     if (depth == 0) {
         pline->cMove = 0;
-        return Evaluate::evaluate(board, color);
+        return Evaluate::evaluate(board, color, accumulators_, alpha, beta);
     }
 
     // generate moves
     std::vector<Move> moves;
     board.pseudoLegalMoves(moves);
 
+    // score moves once before sorting, SEE is too expensive to run on every comparison
+    std::vector<std::pair<int, Move>> scoredMoves;
+    scoredMoves.reserve(moves.size());
+    for (auto m : moves)
+        scoredMoves.emplace_back(board.moveScore(m), m);
+
     // sort moves
-    std::sort(moves.begin(), moves.end(), [&board](const Move &a, const Move &b) {
-        return board.compareMoves(a, b);
+    std::sort(scoredMoves.begin(), scoredMoves.end(), [](const auto &a, const auto &b) {
+        return a.first > b.first;
     });
 
-    for (auto m : moves) {
-        auto turn = board.turn();
-        Board b = board;
+    // losing captures are only pruned at shallow depth, never at the root and never when in check
+    bool allowSeePruning = ply > 0 && depth <= SEE_PRUNING_DEPTH && !board.isCheck(board.turn());
 
-        // check for threefold repetition
-        if (ply == 0 && boardStates[b.hash()] == 2)
+    keyStack_.push_back(board.hash());
+
+    // root moves are only reported once the search takes long enough for the GUI to show them
+    bool reportMoves = ply == 0 && listener_ &&
+                       std::chrono::steady_clock::now() - searchStart_ > std::chrono::milliseconds(CURRMOVE_DELAY);
+    int moveNumber = 0;
+
+    for (auto [moveScore, m] : scoredMoves) {
+        if (ply == 0 && std::find(excludedRootMoves_.begin(), excludedRootMoves_.end(), m) != excludedRootMoves_.end())
             continue;
 
-        b.makeMove(m);
+        // illegal moves are rejected with the pins and checkers of this board, before the move is played
+        if (!board.isLegal(m))
+            continue;
 
-        // ignore move if it results in a check
-        if (b.isCheck(turn))
+        // prune captures that lose a lot of material according to SEE before the move is played, only captures that
+        // already failed SEE with a zero threshold during move ordering have a negative move score; the rare losing
+        // capture that mates is pruned as well
+        if (allowSeePruning && moveScore < 0 && !board.see(m, -SEE_PRUNING_MARGIN * depth))
             continue;
 
+        auto turn = board.turn();
+        Board b = board;
+        b.makeMove(m);
+
         // return maximum score if checkmate is found
         if (b.isCheckMate(!turn)) {
+            keyStack_.pop_back();
             pline->cMove = 1;
             pline->argmove[0] = m;
             return INT32_MAX;
         }
 
+        if (reportMoves)
+            listener_->currentMove(depth, m, ++moveNumber);
+
+        accumulators_.push(b);
         long score = -negamax(b, depth - 1, ply + 1, -beta, -alpha, -color, &line);
+        accumulators_.pop();
 
-        if (score >= beta)
+        if (score >= beta) {
+            keyStack_.pop_back();
             return beta;
+        }
 
         if (score > alpha) {
             alpha = score;
@@ -183,9 +353,37 @@ long ChessEngine::negamax(const Board &board, int depth, int ply, long alpha, lo
         }
     }
 
+    keyStack_.pop_back();
+
     return alpha;
 }
 
+/*
+ * Checks whether the given board state is a draw by the fifty-move rule or by repetition. A checkmated side is never
+ * saved by the fifty-move rule.
+ *
+ * Positions that were already reached once, either during the game or on the current search path, are treated as a
+ * draw. Only positions with the same side to move since the last irreversible move (capture or pawn move) are
+ * compared, since an irreversible move makes it impossible to repeat any earlier position.
+ */
+bool ChessEngine::isDraw(const Board &board) const {
+    // a checkmate on the move that reaches the fifty-move limit still ends the game as a checkmate
+    if (board.halfmoveClock() >= 100)
+        return !board.isCheckMate(board.turn());
+
+    auto hash = board.hash();
+    auto size = keyStack_.size();
+    auto end = std::min<std::size_t>(board.halfmoveClock(), size);
+
+    // the same position can be reached again after at least four halfmoves
+    for (std::size_t i = 4; i <= end; i += 2) {
+        if (keyStack_[size - i] == hash)
+            return true;
+    }
+
+    return false;
+}
+
 std::string ChessEngine::name() const {
     return name_;
 }
@@ -200,6 +398,39 @@ std::string ChessEngine::author() const {
 
 void ChessEngine::newGame() {
     board_ = Fen::createBoard(Board::INITIAL_BOARD_FEN).value();
+    gameHistory_.clear();
+}
+
+/*
+ * Loads the evaluation network from the given file. An empty path unloads the network, in which case the handcrafted
+ * evaluation is used.
+ */
+bool ChessEngine::setEvalFile(const std::string &path) {
+    if (path.empty() || path == "<empty>") {
+        Nnue::unload();
+        return true;
+    }
+
+    return Nnue::load(path);
+}
+
+/*
+ * Sets the number of lines that are searched and reported, the PV returned by a search is always the best line.
+ */
+bool ChessEngine::setMultiPv(int count) {
+    if (count < 1 || count > MAX_MULTI_PV)
+        return false;
+
+    multiPv_ = count;
+    return true;
+}
+
+/*
+ * Sets the hashes of the positions that were played before the position that will be searched next, oldest first.
+ * These are used to detect repetitions.
+ */
+void ChessEngine::setGameHistory(const std::vector<U64> &history) {
+    gameHistory_ = history;
 }
 
 std::chrono::milliseconds ChessEngine::moveTime(PieceColor turn, TimeInfo ti) const {
@@ -4,10 +4,14 @@
 #include "PrincipalVariation.hpp"
 #include "Board.hpp"
 #include "TimeInfo.hpp"
+#include "SearchLimits.hpp"
+#include "Nnue.hpp"
 
 #include <string>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
+#include <chrono>
 
 struct HashInfo {
     std::size_t defaultSize;
@@ -15,9 +19,50 @@ struct HashInfo {
     std::size_t maxSize;
 };
 
+/*
+ * Counters collected during a search.
+ */
+struct SearchStatistics {
+    uint64_t nodes;
+    uint64_t evaluations;
+    uint64_t evalCacheHits;
+    std::chrono::milliseconds time;
+};
+
+/*
+ * Progress of a search, reported for every line of an iteration once that line is searched. Lines are ranked by
+ * multiPv, starting at 1 for the best line.
+ */
+struct SearchInfo {
+    int depth;
+    int selDepth;
+    int multiPv;
+    PrincipalVariation pv;
+    uint64_t nodes;
+    std::chrono::milliseconds time;
+    // permille of the evaluation cache that is in use
+    int hashFull;
+};
+
+/*
+ * Receives the progress of a search while it is running. All calls are made from the thread that runs the search.
+ */
+class SearchListener {
+public:
+
+    virtual ~SearchListener() = default;
+
+    virtual void iterationCompleted(const SearchInfo &info) = 0;
+
+    virtual void currentMove(int depth, const Move &move, int moveNumber) = 0;
+};
+
 class Engine {
 public:
 
+    // maximum number of lines that can be searched in MultiPV mode
+    static constexpr int MAX_MULTI_PV = 256;
+
     virtual ~Engine() = default;
 
     virtual std::string name() const = 0;
@@ -30,12 +75,22 @@ public:
 
     virtual PrincipalVariation pv(
             const Board &board,
-            const TimeInfo::Optional &timeInfo = std::nullopt
+            const SearchLimits &limits = {}
     ) = 0;
 
     virtual std::optional<HashInfo> hashInfo() const;
 
     virtual void setHashSize(std::size_t size);
+
+    virtual void setGameHistory(const std::vector<Board::U64> &history);
+
+    virtual bool setEvalFile(const std::string &path);
+
+    virtual bool setMultiPv(int count);
+
+    virtual std::optional<SearchStatistics> statistics() const;
+
+    virtual void setSearchListener(SearchListener *listener);
 };
 
 typedef struct LINE {
@@ -58,10 +113,10 @@ public:
 
     PrincipalVariation pv(
             const Board &board,
-            const TimeInfo::Optional &timeInfo = std::nullopt
+            const SearchLimits &limits = {}
     ) override;
 
-    PrincipalVariation iterativeDeepening(const Board &board, const TimeInfo::Optional &timeInfo);
+    PrincipalVariation iterativeDeepening(const Board &board, const SearchLimits &limits);
 
     long negamax(const Board &board, int depth, int ply, long alpha, long beta, int color, LINE* pline);
 
@@ -69,14 +124,75 @@ public:
 
     void setNewGame(bool newGame);
 
+    void setGameHistory(const std::vector<U64> &history) override;
+
+    bool setEvalFile(const std::string &path) override;
+
+    bool setMultiPv(int count) override;
+
+    [[nodiscard]] std::optional<SearchStatistics> statistics() const override;
+
+    void setSearchListener(SearchListener *listener) override;
+
+    [[nodiscard]] bool isDraw(const Board &board) const;
+
 private:
+
+    [[nodiscard]] bool limitReached();
+
+    [[nodiscard]] bool isPondering();
+
     std::string name_ = "penguin";
     std::string version_ = "19.8.4";
     std::string author_ = "c0mplex";
 
     Board board_;
 
-    std::map<U64, int> boardStates;
+    // hashes of the positions that were played before the position that is searched
+    std::vector<U64> gameHistory_;
+
+    // hashes of all positions leading to the node that is currently searched: the game history followed by the
+    // positions on the current search path
+    std::vector<U64> keyStack_;
+
+    // network accumulators for the positions on the current search path
+    Nnue::Accumulators accumulators_;
+
+    // number of nodes visited by the current search, every engine instance searches on its own thread so the counter
+    // is never shared
+    U64 nodes_ = 0;
+
+    // deepest ply reached by the current iteration
+    int selDepth_ = 0;
+
+    // start of the current search, used to report the elapsed time
+    std::chrono::steady_clock::time_point searchStart_;
+
+    // limits of the current search, they are only checked once the first iteration completed so a search always has a
+    // move to play
+    SearchLimits limits_;
+    bool limitsArmed_ = false;
+
+    // time from which the time limits are measured, unset while pondering
+    std::optional<std::chrono::steady_clock::time_point> limitStart_;
+
+    // time after which the current search is aborted, if any
+    std::optional<std::chrono::milliseconds> hardTimeLimit_;
+
+    // set when a limit is reached, the iteration that is running is then abandoned
+    bool stopped_ = false;
+
+    // number of lines that are searched and reported
+    int multiPv_ = 1;
+
+    // root moves that are skipped because they are the first move of an earlier line of this iteration
+    std::vector<Move> excludedRootMoves_;
+
+    // receives the progress of the search, if set
+    SearchListener *listener_ = nullptr;
+
+    // statistics of the last search, if it searched at all
+    std::optional<SearchStatistics> statistics_;
 
     bool isInitialBoard = true;
 };
@@ -1,43 +1,64 @@
 #include "Evaluate.h"
 
+#include <vector>
+#include <algorithm>
+
+#define FILE_A 0x0101010101010101L
+#define FILE_H 0x8080808080808080L
+
 #define bit 1UL
 #define NBB 12
 #define NSQ 64
 
+#define PAWN_TABLE_SIZE 16384 // number of entries in the pawn hash table, must be a power of two
+#define EVAL_CACHE_SIZE 65536 // number of entries in the evaluation cache, must be a power of two
+#define LAZY_MARGIN 400 // expected bound of the terms that are skipped by lazy evaluation, not a strict maximum
+
+#define ISOLATED_PAWN_PENALTY makeScore(15, 20)
+#define DOUBLED_PAWN_PENALTY makeScore(10, 25)
+#define BACKWARD_PAWN_PENALTY makeScore(8, 10)
+#define KING_ZONE_ATTACK_PENALTY makeScore(8, 0)
+
+using U64 = uint64_t;
+
 /*
- * Returns a score for the given board state.
- *
- * Currently used evaluation functions:
- *  - material value
- *  - piece-square tables
+ * An entry of the pawn hash table, stores the pawn structure score for the pawns with the given pawn hash.
  */
-int Evaluate::evaluate(const Board &board, int who2move) {
-    int score = 0;
-    auto bitboards = board.getBitboards();
+struct PawnEntry {
+    U64 key = 0;
+    Score score = 0;
+    bool valid = false;
+};
 
-    // material
-    for (int i = 0; i < 6; i++) {
-        score += Board::popCount(bitboards[i]) * Board::bitboardTypes[i].value();
-        score -= Board::popCount(bitboards[i + 6]) * Board::bitboardTypes[i].value();
-    }
+/*
+ * An entry of the evaluation cache, stores the score from the perspective of white for the board with the given hash.
+ */
+struct EvalEntry {
+    U64 key = 0;
+    int score = 0;
+    bool valid = false;
+};
 
-    // piece square tables
-    for (int i = 0; i < 6; i++) {
-        auto bbw = bitboards[i];
-        auto bbb = bitboards[i + 6];
-        for (int j = 0; j < NSQ; j++) {
-            if (bbw & bit << j)
-                score += pieceSquareTables[i][j];
-            if (bbb & bit << j)
-                score -= pieceSquareTables[i][j];
-        }
-    }
+// every search thread gets its own hash tables so no synchronization is needed
+static thread_local std::vector<PawnEntry> pawnTable(PAWN_TABLE_SIZE);
+static thread_local std::vector<EvalEntry> evalCache(EVAL_CACHE_SIZE);
+static thread_local Evaluate::Statistics evalStatistics;
 
-    return who2move * score;
-}
+/*
+ * Material value of the pieces, in the order of the bitboards.
+ * Kings are always on the board, so they don't contribute to the material balance.
+ */
+static constexpr Score pieceValues[6] = {
+        makeScore(0, 0),
+        makeScore(900, 940),
+        makeScore(500, 520),
+        makeScore(330, 320),
+        makeScore(320, 290),
+        makeScore(100, 120)
+};
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::kingTableWhite[64] = {
+static constexpr int kingMidgameTable[64] = {
         20, 30, 10, 0, 0, 10, 30, 20,
         20, 20, 0, 0, 0, 0, 20, 20,
         -10, -20, -20, -20, -20, -20, -20, -10,
@@ -49,19 +70,19 @@ const int Evaluate::kingTableWhite[64] = {
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::kingTableBlack[64] = {
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -30, -40, -40, -50, -50, -40, -40, -30,
-        -20, -30, -30, -40, -40, -30, -30, -20,
-        -10, -20, -20, -20, -20, -20, -20, -10,
-        20, 20, 0, 0, 0, 0, 20, 20,
-        20, 30, 10, 0, 0, 10, 30, 20
+static constexpr int kingEndgameTable[64] = {
+        -50, -30, -30, -30, -30, -30, -30, -50,
+        -30, -30, 0, 0, 0, 0, -30, -30,
+        -30, -10, 20, 30, 30, 20, -10, -30,
+        -30, -10, 30, 40, 40, 30, -10, -30,
+        -30, -10, 30, 40, 40, 30, -10, -30,
+        -30, -10, 20, 30, 30, 20, -10, -30,
+        -30, -20, -10, 0, 0, -10, -20, -30,
+        -50, -40, -30, -20, -20, -30, -40, -50
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::queenTableWhite[64] = {
+static constexpr int queenTable[64] = {
         -20, -10, -10, -5, -5, -10, -10, -20,
         -10, 0, 5, 0, 0, 0, 0, -10,
         -10, 5, 5, 5, 5, 5, 0, -10,
@@ -73,19 +94,7 @@ const int Evaluate::queenTableWhite[64] = {
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::queenTableBlack[64] = {
-        -20, -10, -10, -5, -5, -10, -10, -20,
-        -10, 0, 0, 0, 0, 0, 0, -10,
-        -10, 0, 5, 5, 5, 5, 0, -10,
-        -5, 0, 5, 5, 5, 5, 0, -5,
-        0, 0, 5, 5, 5, 5, 0, -5,
-        -10, 5, 5, 5, 5, 5, 0, -10,
-        -10, 0, 5, 0, 0, 0, 0, -10,
-        -20, -10, -10, -5, -5, -10, -10, -20
-};
-
-// source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::rookTableWhite[64] = {
+static constexpr int rookTable[64] = {
         0, 0, 0, 5, 5, 0, 0, 0,
         -5, 0, 0, 0, 0, 0, 0, -5,
         -5, 0, 0, 0, 0, 0, 0, -5,
@@ -97,19 +106,7 @@ const int Evaluate::rookTableWhite[64] = {
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::rookTableBlack[64] = {
-        0, 0, 0, 0, 0, 0, 0, 0,
-        5, 10, 10, 10, 10, 10, 10, 5,
-        -5, 0, 0, 0, 0, 0, 0, -5,
-        -5, 0, 0, 0, 0, 0, 0, -5,
-        -5, 0, 0, 0, 0, 0, 0, -5,
-        -5, 0, 0, 0, 0, 0, 0, -5,
-        -5, 0, 0, 0, 0, 0, 0, -5,
-        0, 0, 0, 5, 5, 0, 0, 0
-};
-
-// source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::bishopTableWhite[64] = {
+static constexpr int bishopTable[64] = {
         -20, -10, -10, -10, -10, -10, -10, -20,
         -10, 5, 0, 0, 0, 0, 5, -10,
         -10, 10, 10, 10, 10, 10, 10, -10,
@@ -121,19 +118,7 @@ const int Evaluate::bishopTableWhite[64] = {
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::bishopTableBlack[64] = {
-        -20, -10, -10, -10, -10, -10, -10, -20,
-        -10, 0, 0, 0, 0, 0, 0, -10,
-        -10, 0, 5, 10, 10, 5, 0, -10,
-        -10, 5, 5, 10, 10, 5, 5, -10,
-        -10, 0, 10, 10, 10, 10, 0, -10,
-        -10, 10, 10, 10, 10, 10, 10, -10,
-        -10, 5, 0, 0, 0, 0, 5, -10,
-        -20, -10, -10, -10, -10, -10, -10, -20,
-};
-
-// source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::knightTableWhite[64] = {
+static constexpr int knightTable[64] = {
         -50, -40, -30, -30, -30, -30, -40, -50,
         -40, -20, 0, 5, 5, 0, -20, -40,
         -30, 5, 10, 15, 15, 10, 5, -30,
@@ -145,19 +130,7 @@ const int Evaluate::knightTableWhite[64] = {
 };
 
 // source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::knightTableBlack[64] = {
-        -50, -40, -30, -30, -30, -30, -40, -50,
-        -40, -20, 0, 0, 0, 0, -20, -40,
-        -30, 0, 10, 15, 15, 10, 0, -30,
-        -30, 5, 15, 20, 20, 15, 5, -30,
-        -30, 0, 15, 20, 20, 15, 0, -30,
-        -30, 5, 10, 15, 15, 10, 5, -30,
-        -40, -20, 0, 5, 5, 0, -20, -40,
-        -50, -40, -30, -30, -30, -30, -40, -50,
-};
-
-// source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::pawnTableWhite[64] = {
+static constexpr int pawnMidgameTable[64] = {
         0, 0, 0, 0, 0, 0, 0, 0,
         5, 10, 10, -20, -20, 10, 10, 5,
         5, -5, -10, 0, 0, -10, -5, 5,
@@ -168,29 +141,375 @@ const int Evaluate::pawnTableWhite[64] = {
         0, 0, 0, 0, 0, 0, 0, 0
 };
 
-// source: https://www.chessprogramming.org/Simplified_Evaluation_Function
-const int Evaluate::pawnTableBlack[64] = {
+// in the endgame, pawns are rewarded for advancing regardless of the file they are on
+static constexpr int pawnEndgameTable[64] = {
         0, 0, 0, 0, 0, 0, 0, 0,
-        50, 50, 50, 50, 50, 50, 50, 50,
-        10, 10, 20, 30, 30, 20, 10, 10,
-        5, 5, 10, 25, 25, 10, 5, 5,
-        0, 0, 0, 20, 20, 0, 0, 0,
-        5, -5, -10, 0, 0, -10, -5, 5,
-        5, 10, 10, -20, -20, 10, 10, 5,
+        0, 0, 0, 0, 0, 0, 0, 0,
+        5, 5, 5, 5, 5, 5, 5, 5,
+        10, 10, 10, 10, 10, 10, 10, 10,
+        20, 20, 20, 20, 20, 20, 20, 20,
+        35, 35, 35, 35, 35, 35, 35, 35,
+        60, 60, 60, 60, 60, 60, 60, 60,
         0, 0, 0, 0, 0, 0, 0, 0
 };
 
-const int *Evaluate::pieceSquareTables[12] = {
-        kingTableWhite,
-        queenTableWhite,
-        rookTableWhite,
-        bishopTableWhite,
-        knightTableWhite,
-        pawnTableWhite,
-        kingTableBlack,
-        queenTableBlack,
-        rookTableBlack,
-        bishopTableBlack,
-        knightTableBlack,
-        pawnTableBlack
+/*
+ * Middlegame and endgame piece-square tables, in the order of the bitboards. The tables are from the perspective of
+ * white, with a1 as the first square.
+ */
+static constexpr const int *midgameTables[6] = {
+        kingMidgameTable, queenTable, rookTable, bishopTable, knightTable, pawnMidgameTable
+};
+
+static constexpr const int *endgameTables[6] = {
+        kingEndgameTable, queenTable, rookTable, bishopTable, knightTable, pawnEndgameTable
+};
+
+/*
+ * Material and piece-square score of every piece on every square, in the order of the bitboards.
+ * Black pieces use the table of the white piece on the vertically mirrored square, with a negated score.
+ */
+struct PieceSquareTable {
+    Score scores[NBB][NSQ];
 };
+
+static constexpr PieceSquareTable makePieceSquareTable() {
+    PieceSquareTable table{};
+
+    for (int bitboard = 0; bitboard < NBB; bitboard++) {
+        auto type = bitboard % 6;
+        bool white = bitboard < 6;
+
+        for (int square = 0; square < NSQ; square++) {
+            auto relative = white ? square : square ^ 56;
+            Score score = pieceValues[type] + makeScore(midgameTables[type][relative], endgameTables[type][relative]);
+            table.scores[bitboard][square] = white ? score : -score;
+        }
+    }
+
+    return table;
+}
+
+static constexpr PieceSquareTable pieceSquareTable = makePieceSquareTable();
+
+/*
+ * Set-wise helpers for the pawn structure evaluation.
+ * Source: https://www.chessprogramming.org/Pawn_Fills
+ */
+static U64 northFill(U64 bb) {
+    bb |= bb << 8;
+    bb |= bb << 16;
+    bb |= bb << 32;
+    return bb;
+}
+
+static U64 southFill(U64 bb) {
+    bb |= bb >> 8;
+    bb |= bb >> 16;
+    bb |= bb >> 32;
+    return bb;
+}
+
+static U64 fileFill(U64 bb) {
+    return northFill(bb) | southFill(bb);
+}
+
+static U64 eastOne(U64 bb) {
+    return (bb << 1) & ~FILE_A;
+}
+
+static U64 westOne(U64 bb) {
+    return (bb >> 1) & ~FILE_H;
+}
+
+/*
+ * Returns a score for the given board state.
+ *
+ * Currently used evaluation functions:
+ *  - material value
+ *  - piece-square tables
+ *  - pawn structure
+ *  - mobility
+ *  - king safety
+ *
+ * Every term has a middlegame and an endgame value, the final score is interpolated between the two based on the game
+ * phase of the board.
+ *
+ * The evaluation is done in tiers: material and piece-square tables are maintained incrementally by the board and are
+ * always used. When that score is already far outside the [alpha, beta] window, the more expensive terms are unlikely
+ * to bring it back inside, so the cheap score is returned right away (lazy evaluation).
+ *
+ * Exact scores are cached by the hash of the board, so positions that are reached again through transpositions or in
+ * the next iteration of iterative deepening are only evaluated once.
+ */
+int Evaluate::evaluate(const Board &board, int who2move, long alpha, long beta) {
+    int score;
+    if (probeCache(board.hash(), score))
+        return who2move * score;
+
+    // promotions can increase the phase beyond its starting value
+    int phase = std::min(board.phase(), MAX_PHASE);
+
+    // tier 1: incrementally updated terms
+    Score tiered = board.pieceSquareScore();
+    int lazy = who2move * taper(tiered, phase);
+
+    // the margin is a heuristic, pawn structure, mobility and king safety together can exceed it in extreme positions,
+    // in which case the lazy score is off by more than the margin
+    if (lazy + LAZY_MARGIN <= alpha || lazy - LAZY_MARGIN >= beta)
+        return lazy;
+
+    // tier 2: terms that have to be computed
+    tiered += probePawns(board);
+    tiered += evaluateMobility(board);
+    tiered += evaluateKingSafety(board);
+
+    score = taper(tiered, phase);
+    storeCache(board.hash(), score);
+    return who2move * score;
+}
+
+/*
+ * Returns a score for the given board state, using the neural network if one is loaded.
+ *
+ * The accumulators must have the given board on top of their stack.
+ */
+int Evaluate::evaluate(const Board &board, int who2move, Nnue::Accumulators &accumulators, long alpha, long beta) {
+    if (!Nnue::isLoaded())
+        return evaluate(board, who2move, alpha, beta);
+
+    auto key = board.hash() ^ Nnue::networkKey();
+
+    int score;
+    if (!probeCache(key, score)) {
+        // the network scores from the perspective of the side to move
+        int turn = board.turn() == PieceColor::White ? 1 : -1;
+        score = turn * accumulators.evaluate(board);
+        storeCache(key, score);
+    }
+
+    return who2move * score;
+}
+
+/*
+ * Interpolates between the middlegame and the endgame value of the given score based on the game phase.
+ */
+int Evaluate::taper(Score score, int phase) {
+    return (mgValue(score) * phase + egValue(score) * (MAX_PHASE - phase)) / MAX_PHASE;
+}
+
+/*
+ * Looks up the score for the given key in the evaluation cache of the current thread.
+ */
+bool Evaluate::probeCache(U64 key, int &score) {
+    evalStatistics.evaluations++;
+
+    auto &entry = evalCache[key & (EVAL_CACHE_SIZE - 1)];
+    if (!entry.valid || entry.key != key)
+        return false;
+
+    evalStatistics.cacheHits++;
+    score = entry.score;
+    return true;
+}
+
+void Evaluate::storeCache(U64 key, int score) {
+    evalCache[key & (EVAL_CACHE_SIZE - 1)] = {key, score, true};
+}
+
+/*
+ * Returns the evaluation counters of the current thread.
+ */
+Evaluate::Statistics Evaluate::statistics() {
+    return evalStatistics;
+}
+
+void Evaluate::resetStatistics() {
+    evalStatistics = Statistics();
+}
+
+/*
+ * Returns how full the evaluation cache of the current thread is in permille, estimated from its first 1000 entries.
+ */
+int Evaluate::cacheUsage() {
+    int used = 0;
+    for (int i = 0; i < 1000; i++)
+        used += evalCache[i].valid;
+
+    return used;
+}
+
+/*
+ * Returns the material and piece-square score of a piece of the given bitboard on the given square.
+ * Scores of black pieces are negative.
+ */
+Score Evaluate::pieceSquareScore(int bitboard, unsigned int square) {
+    return pieceSquareTable.scores[bitboard][square];
+}
+
+/*
+ * Returns how much a piece of the given bitboard contributes to the game phase.
+ */
+int Evaluate::phaseWeight(int bitboard) {
+    return phaseWeights[bitboard % 6];
+}
+
+/*
+ * Returns the pawn structure score of the given board, from the perspective of white.
+ *
+ * The pawn structure rarely changes along a search path, so the score is cached in a hash table keyed by the pawn hash
+ * of the board.
+ */
+Score Evaluate::probePawns(const Board &board) {
+    auto key = board.pawnHash();
+    auto &entry = pawnTable[key & (PAWN_TABLE_SIZE - 1)];
+
+    if (!entry.valid || entry.key != key) {
+        auto &bitboards = board.getBitboards();
+        entry.key = key;
+        entry.score = evaluatePawns(bitboards[5], bitboards[11]);
+        entry.valid = true;
+    }
+
+    return entry.score;
+}
+
+/*
+ * Returns the pawn structure score for the given pawns, from the perspective of white.
+ *
+ * All terms are computed set-wise, i.e., for all pawns at once using fills and spans:
+ *  - passed pawns: no enemy pawn in front of them on the same or an adjacent file
+ *  - isolated pawns: no friendly pawn on an adjacent file
+ *  - doubled pawns: a friendly pawn in front of them on the same file
+ *  - backward pawns: the stop square is attacked by an enemy pawn and can never be defended by a friendly pawn
+ *
+ * Source: https://www.chessprogramming.org/Pawn_Structure
+ */
+Score Evaluate::evaluatePawns(U64 whitePawns, U64 blackPawns) {
+    Score score = 0;
+
+    // squares in front of the pawns, including the adjacent files
+    U64 whiteFrontSpan = northFill(whitePawns << 8);
+    U64 blackFrontSpan = southFill(blackPawns >> 8);
+    U64 whiteFrontSpans = whiteFrontSpan | eastOne(whiteFrontSpan) | westOne(whiteFrontSpan);
+    U64 blackFrontSpans = blackFrontSpan | eastOne(blackFrontSpan) | westOne(blackFrontSpan);
+
+    // passed pawns
+    U64 whitePassed = whitePawns & ~blackFrontSpans;
+    U64 blackPassed = blackPawns & ~whiteFrontSpans;
+
+    for (int rank = 1; rank < 7; rank++) {
+        U64 rankMask = 0xFFUL << (8 * rank);
+        score += Board::popCount(whitePassed & rankMask) * passedPawnBonus[rank];
+        score -= Board::popCount(blackPassed & rankMask) * passedPawnBonus[7 - rank];
+    }
+
+    // isolated pawns
+    U64 whiteFiles = fileFill(whitePawns);
+    U64 blackFiles = fileFill(blackPawns);
+    U64 whiteIsolated = whitePawns & ~(eastOne(whiteFiles) | westOne(whiteFiles));
+    U64 blackIsolated = blackPawns & ~(eastOne(blackFiles) | westOne(blackFiles));
+    score -= Board::popCount(whiteIsolated) * ISOLATED_PAWN_PENALTY;
+    score += Board::popCount(blackIsolated) * ISOLATED_PAWN_PENALTY;
+
+    // doubled pawns
+    U64 whiteDoubled = whitePawns & whiteFrontSpan;
+    U64 blackDoubled = blackPawns & blackFrontSpan;
+    score -= Board::popCount(whiteDoubled) * DOUBLED_PAWN_PENALTY;
+    score += Board::popCount(blackDoubled) * DOUBLED_PAWN_PENALTY;
+
+    // backward pawns
+    U64 whiteAttacks = eastOne(whitePawns << 8) | westOne(whitePawns << 8);
+    U64 blackAttacks = eastOne(blackPawns >> 8) | westOne(blackPawns >> 8);
+    U64 whiteAttackSpans = northFill(whiteAttacks);
+    U64 blackAttackSpans = southFill(blackAttacks);
+    U64 whiteBackward = ((whitePawns << 8) & blackAttacks & ~whiteAttackSpans) >> 8;
+    U64 blackBackward = ((blackPawns >> 8) & whiteAttacks & ~blackAttackSpans) << 8;
+    score -= Board::popCount(whiteBackward) * BACKWARD_PAWN_PENALTY;
+    score += Board::popCount(blackBackward) * BACKWARD_PAWN_PENALTY;
+
+    return score;
+}
+
+/*
+ * Returns the mobility score of the board, from the perspective of white.
+ *
+ * Mobility is the number of squares attacked by the pieces of a bitboard that are not occupied by a friendly piece
+ * and not attacked by an enemy pawn. It is counted per bitboard rather than per piece, squares attacked by two pieces
+ * of the same type only count once.
+ */
+Score Evaluate::evaluateMobility(const Board &board) {
+    auto &info = board.attackInfo();
+    auto &bitboards = board.getBitboards();
+
+    U64 white = 0UL, black = 0UL;
+    for (int i = 0; i < 6; i++) {
+        white |= bitboards[i];
+        black |= bitboards[i + 6];
+    }
+
+    U64 whiteArea = ~white & ~info.attacks[11];
+    U64 blackArea = ~black & ~info.attacks[5];
+
+    Score score = 0;
+    for (int i = 0; i < 6; i++) {
+        score += Board::popCount(info.attacks[i] & whiteArea) * mobilityBonus[i];
+        score -= Board::popCount(info.attacks[i + 6] & blackArea) * mobilityBonus[i];
+    }
+
+    return score;
+}
+
+/*
+ * Returns the king safety score of the board, from the perspective of white.
+ *
+ * The king zone is the king and the squares around it, every square of the zone that is attacked by the opponent is
+ * penalized. An exposed king only matters while there are enough pieces left to attack it.
+ */
+Score Evaluate::evaluateKingSafety(const Board &board) {
+    auto &info = board.attackInfo();
+    auto &bitboards = board.getBitboards();
+
+    U64 whiteZone = info.attacks[0] | bitboards[0];
+    U64 blackZone = info.attacks[6] | bitboards[6];
+
+    Score score = 0;
+    score -= Board::popCount(whiteZone & info.attacked[1]) * KING_ZONE_ATTACK_PENALTY;
+    score += Board::popCount(blackZone & info.attacked[0]) * KING_ZONE_ATTACK_PENALTY;
+    return score;
+}
+
+/*
+ * Bonus per square a piece can move to, in the order of the bitboards.
+ * Kings and pawns don't get a mobility bonus, king safety and pawn structure are evaluated separately.
+ */
+const Score Evaluate::mobilityBonus[6] = {
+        makeScore(0, 0),
+        makeScore(1, 2),
+        makeScore(2, 4),
+        makeScore(5, 5),
+        makeScore(4, 4),
+        makeScore(0, 0)
+};
+
+/*
+ * Bonus for a passed pawn, indexed by the rank of the pawn relative to its color.
+ * Passed pawns become a lot more valuable once the pieces that could stop them are traded.
+ */
+const Score Evaluate::passedPawnBonus[8] = {
+        makeScore(0, 0),
+        makeScore(5, 10),
+        makeScore(5, 15),
+        makeScore(10, 30),
+        makeScore(20, 55),
+        makeScore(35, 95),
+        makeScore(60, 150),
+        makeScore(0, 0)
+};
+
+/*
+ * Contribution of the pieces to the game phase, in the order of the bitboards.
+ * Source: https://www.chessprogramming.org/Tapered_Eval
+ */
+const int Evaluate::phaseWeights[6] = {0, 4, 2, 1, 1, 0};
+
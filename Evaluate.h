@@ -6,28 +6,63 @@
 #define CPLCHESS_EVALUATE_H
 
 #include "Board.hpp"
+#include "Score.hpp"
+#include "Nnue.hpp"
+
+#include <cstdint>
+#include <limits>
 
 class Evaluate {
 
 public:
-    static int evaluate(const Board &board, int who2move);
+    using U64 = uint64_t;
+
+    /*
+     * Counters of the evaluations done by the current thread.
+     */
+    struct Statistics {
+        U64 evaluations = 0;
+        U64 cacheHits = 0;
+    };
+
+    static int evaluate(const Board &board, int who2move, long alpha = std::numeric_limits<long>::min(),
+                        long beta = std::numeric_limits<long>::max());
+
+    static int evaluate(const Board &board, int who2move, Nnue::Accumulators &accumulators,
+                        long alpha = std::numeric_limits<long>::min(), long beta = std::numeric_limits<long>::max());
+
+    static Score evaluatePawns(U64 whitePawns, U64 blackPawns);
+
+    static Score evaluateMobility(const Board &board);
+
+    static Score evaluateKingSafety(const Board &board);
+
+    static Score pieceSquareScore(int bitboard, unsigned square);
+
+    static int phaseWeight(int bitboard);
+
+    static Statistics statistics();
+
+    static void resetStatistics();
+
+    static int cacheUsage();
+
+    // game phase of the starting position, the phase of a board goes down to 0 as pieces are traded
+    static constexpr int MAX_PHASE = 24;
 
-    // seriously cba to implement a mirror function, so just doing the mirror manually
 private:
-    static const int pawnTableWhite[64];
-    static const int pawnTableBlack[64];
-    static const int knightTableWhite[64];
-    static const int knightTableBlack[64];
-    static const int bishopTableWhite[64];
-    static const int bishopTableBlack[64];
-    static const int rookTableWhite[64];
-    static const int rookTableBlack[64];
-    static const int queenTableWhite[64];
-    static const int queenTableBlack[64];
-    static const int kingTableWhite[64];
-    static const int kingTableBlack[64];
-
-    static const int *pieceSquareTables[12];
+    static const int phaseWeights[6];
+
+    static const Score passedPawnBonus[8];
+    static const Score mobilityBonus[6];
+
+    static Score probePawns(const Board &board);
+
+    static int taper(Score score, int phase);
+
+    static bool probeCache(U64 key, int &score);
+
+    static void storeCache(U64 key, int score);
 
 };
 
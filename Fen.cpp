@@ -2,19 +2,31 @@
 
 #include "Square.hpp"
 
-#include <sstream>
-#include <iostream>
+#include <charconv>
+#include <algorithm>
 
 const char* const Fen::StartingPos =
     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
-static std::string nextField(std::istream& stream) {
-    auto field = std::string();
-    stream >> field;
+static constexpr std::string_view Whitespace = " \t\r\n";
+
+/*
+ * Removes the next field from the given text and returns it, fields are separated by whitespace. Returns an empty
+ * field at the end of the text.
+ */
+static std::string_view nextField(std::string_view& text) {
+    text.remove_prefix(std::min(text.find_first_not_of(Whitespace), text.size()));
+    auto field = text.substr(0, text.find_first_of(Whitespace));
+    text.remove_prefix(field.size());
     return field;
 }
 
-static bool parsePlacement(const std::string& placement, Board& board) {
+static std::string_view trim(std::string_view text) {
+    text.remove_prefix(std::min(text.find_first_not_of(Whitespace), text.size()));
+    return text.substr(0, text.find_last_not_of(Whitespace) + 1);
+}
+
+static bool parsePlacement(std::string_view placement, Board& board) {
     auto currentFile = Square::Coordinate(0);
     auto currentRank = Square::Coordinate(7);
 
@@ -54,7 +66,7 @@ static bool parsePlacement(const std::string& placement, Board& board) {
     return true;
 }
 
-static bool parseTurn(const std::string& turn, Board& board) {
+static bool parseTurn(std::string_view turn, Board& board) {
     if (turn == "w") {
         board.setTurn(PieceColor::White);
         return true;
@@ -66,7 +78,7 @@ static bool parseTurn(const std::string& turn, Board& board) {
     }
 }
 
-static bool parseCastlingRights(const std::string& rights, Board& board) {
+static bool parseCastlingRights(std::string_view rights, Board& board) {
     if (rights == "-") {
         board.setCastlingRights(CastlingRights::None);
         return true;
@@ -88,7 +100,7 @@ static bool parseCastlingRights(const std::string& rights, Board& board) {
     return true;
 }
 
-static bool parseEnPassantSquare(const std::string& ep, Board& board) {
+static bool parseEnPassantSquare(std::string_view ep, Board& board) {
     if (ep == "-") {
         // No en passant square
         return true;
@@ -104,65 +116,236 @@ static bool parseEnPassantSquare(const std::string& ep, Board& board) {
     }
 }
 
-Board::Optional Fen::createBoard(std::istream& fenStream) {
-    auto placement = nextField(fenStream);
+static std::optional<unsigned> parseNumber(std::string_view field) {
+    auto value = 0u;
+    auto end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, value);
 
-    if (placement.empty()) {
+    if (field.empty() || ec != std::errc() || ptr != end) {
         return std::nullopt;
     }
 
+    return value;
+}
+
+/*
+ * Parses the fields that FEN and EPD have in common: piece placement, side to move, castling rights and en passant
+ * square. The fields are removed from the given text.
+ */
+static Board::Optional parsePosition(std::string_view& text) {
     auto board = Board();
 
-    if (!parsePlacement(placement, board)) {
+    if (!parsePlacement(nextField(text), board)) {
         return std::nullopt;
     }
 
-    auto turn = nextField(fenStream);
+    if (!parseTurn(nextField(text), board)) {
+        return std::nullopt;
+    }
 
-    if (turn.empty()) {
+    if (!parseCastlingRights(nextField(text), board)) {
         return std::nullopt;
     }
 
-    if (!parseTurn(turn, board)) {
+    if (!parseEnPassantSquare(nextField(text), board)) {
         return std::nullopt;
     }
 
-    auto castlingRights = nextField(fenStream);
+    return board;
+}
+
+/*
+ * Creates a board from the given FEN. The halfmove clock and fullmove number are optional, they default to 0 and 1.
+ *
+ * The text is parsed in place, nothing is allocated.
+ */
+Board::Optional Fen::createBoard(std::string_view fen) {
+    auto board = parsePosition(fen);
 
-    if (castlingRights.empty()) {
+    if (!board.has_value()) {
         return std::nullopt;
     }
 
-    if (!parseCastlingRights(castlingRights, board)) {
-        return std::nullopt;
+    if (auto halfmove = nextField(fen); !halfmove.empty()) {
+        auto clock = parseNumber(halfmove);
+
+        if (!clock.has_value()) {
+            return std::nullopt;
+        }
+
+        board->setHalfmoveClock(clock.value());
     }
 
-    auto ep = nextField(fenStream);
+    if (auto fullmove = nextField(fen); !fullmove.empty()) {
+        auto number = parseNumber(fullmove);
 
-    if (ep.empty()) {
-        return std::nullopt;
+        if (!number.has_value() || number.value() == 0) {
+            return std::nullopt;
+        }
+
+        board->setFullmoveNumber(number.value());
     }
 
-    if (!parseEnPassantSquare(ep, board)) {
+    return board;
+}
+
+/*
+ * Parses a line of an EPD file. The halfmove clock and fullmove number are taken from the `hmvc` and `fmvn` operations
+ * when they are present. Many EPD files contain full FENs, so counters after the en passant square are read like in a
+ * FEN; an opcode never starts with a digit.
+ */
+std::optional<Fen::Epd> Fen::parseEpd(std::string_view epd) {
+    auto board = parsePosition(epd);
+
+    if (!board.has_value()) {
         return std::nullopt;
     }
 
-    auto halfmove = nextField(fenStream);
+    for (auto counter = 0; counter < 2; counter++) {
+        auto rest = epd;
+        auto value = parseNumber(nextField(rest));
 
-    if (halfmove.empty()) {
-        return std::nullopt;
+        if (!value.has_value()) {
+            break;
+        }
+
+        if (counter == 0) {
+            board->setHalfmoveClock(value.value());
+        } else if (value.value() > 0) {
+            board->setFullmoveNumber(value.value());
+        } else {
+            return std::nullopt;
+        }
+
+        epd = rest;
     }
 
-    auto fullmove = nextField(fenStream);
+    auto record = Epd{board.value(), trim(epd)};
 
-    if (fullmove.empty()) {
-        return std::nullopt;
+    if (auto clock = record.operation("hmvc"); clock.has_value()) {
+        auto value = parseNumber(clock.value());
+
+        if (!value.has_value()) {
+            return std::nullopt;
+        }
+
+        record.board.setHalfmoveClock(value.value());
     }
 
-    return board;
+    if (auto number = record.operation("fmvn"); number.has_value()) {
+        auto value = parseNumber(number.value());
+
+        if (!value.has_value() || value.value() == 0) {
+            return std::nullopt;
+        }
+
+        record.board.setFullmoveNumber(value.value());
+    }
+
+    return record;
 }
 
-Board::Optional Fen::createBoard(const std::string& fen) {
-    auto fenStream = std::stringstream(fen);
-    return createBoard(fenStream);
+/*
+ * Returns the operand of the first operation with the given opcode, without surrounding quotes. Operations are
+ * terminated by a semicolon, semicolons inside quoted strings are part of the operand.
+ */
+std::optional<std::string_view> Fen::Epd::operation(std::string_view opcode) const {
+    auto rest = operations;
+
+    while (!rest.empty()) {
+        auto end = std::size_t(0);
+        auto quoted = false;
+
+        while (end < rest.size() && (quoted || rest[end] != ';')) {
+            quoted ^= rest[end] == '"';
+            end++;
+        }
+
+        auto op = trim(rest.substr(0, end));
+        rest.remove_prefix(std::min(end + 1, rest.size()));
+
+        if (nextField(op) != opcode) {
+            continue;
+        }
+
+        auto operand = trim(op);
+
+        if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+            operand = operand.substr(1, operand.size() - 2);
+        }
+
+        return operand;
+    }
+
+    return std::nullopt;
+}
+
+static void appendNumber(std::string& text, unsigned number) {
+    char digits[16];
+    auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+    text.append(digits, end);
+}
+
+/*
+ * Returns the FEN of the given board.
+ */
+std::string Fen::toFen(const Board& board) {
+    auto fen = std::string();
+    fen.reserve(90);
+
+    for (int rank = 7; rank >= 0; rank--) {
+        auto empty = 0;
+
+        for (int file = 0; file < 8; file++) {
+            auto piece = board.piece(unsigned(rank * 8 + file));
+
+            if (!piece.has_value()) {
+                empty++;
+                continue;
+            }
+
+            if (empty > 0) {
+                fen += static_cast<char>('0' + empty);
+                empty = 0;
+            }
+
+            fen += piece->toSymbol();
+        }
+
+        if (empty > 0) {
+            fen += static_cast<char>('0' + empty);
+        }
+
+        if (rank > 0) {
+            fen += '/';
+        }
+    }
+
+    fen += board.turn() == PieceColor::White ? " w " : " b ";
+
+    auto cr = board.castlingRights();
+
+    if (cr == CastlingRights::None) {
+        fen += '-';
+    } else {
+        if ((cr & CastlingRights::WhiteKingside) != CastlingRights::None) fen += 'K';
+        if ((cr & CastlingRights::WhiteQueenside) != CastlingRights::None) fen += 'Q';
+        if ((cr & CastlingRights::BlackKingside) != CastlingRights::None) fen += 'k';
+        if ((cr & CastlingRights::BlackQueenside) != CastlingRights::None) fen += 'q';
+    }
+
+    fen += ' ';
+
+    if (auto ep = board.enPassantSquare(); ep.has_value()) {
+        fen += ep->toName();
+    } else {
+        fen += '-';
+    }
+
+    fen += ' ';
+    appendNumber(fen, board.halfmoveClock());
+    fen += ' ';
+    appendNumber(fen, board.fullmoveNumber());
+
+    return fen;
 }
@@ -4,13 +4,28 @@
 #include "Board.hpp"
 
 #include <string>
-#include <iosfwd>
+#include <string_view>
+#include <optional>
 
 namespace Fen {
     extern const char* const StartingPos;
 
-    Board::Optional createBoard(std::istream& fenStream);
-    Board::Optional createBoard(const std::string& fen);
+    /*
+     * A position from an EPD file: the first four FEN fields followed by operations, e.g. `bm Nf3; id "test 1";`.
+     */
+    struct Epd {
+        Board board;
+        // all operations of the record, a view into the parsed text
+        std::string_view operations;
+
+        [[nodiscard]] std::optional<std::string_view> operation(std::string_view opcode) const;
+    };
+
+    Board::Optional createBoard(std::string_view fen);
+
+    std::optional<Epd> parseEpd(std::string_view epd);
+
+    std::string toFen(const Board& board);
 }
 
 #endif
@@ -0,0 +1,126 @@
+#include "Logger.hpp"
+
+#include <chrono>
+
+#define LOG_BUFFER_SIZE 4096 // number of messages the ring buffer holds, must be a power of two
+#define LOG_FLUSH_INTERVAL 50 // milliseconds between two batches written by the writer thread
+
+Logger::Logger() : slots_(std::make_unique<Slot[]>(LOG_BUFFER_SIZE)) {
+    for (std::size_t i = 0; i < LOG_BUFFER_SIZE; i++)
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+Logger::~Logger() {
+    close();
+}
+
+/*
+ * Opens the given log file, replacing the file that is currently open. An empty path only closes the current file.
+ */
+bool Logger::open(const std::string &path) {
+    close();
+
+    if (path.empty() || path == "<empty>")
+        return true;
+
+    file_.open(path);
+    if (!file_)
+        return false;
+
+    stopWriter_ = false;
+    writer_ = std::thread(&Logger::writeLoop, this);
+    open_ = true;
+    return true;
+}
+
+/*
+ * Writes the messages that are still buffered and closes the log file.
+ */
+void Logger::close() {
+    if (!writer_.joinable())
+        return;
+
+    open_ = false;
+
+    {
+        std::lock_guard lock(writerMutex_);
+        stopWriter_ = true;
+    }
+
+    writerCondition_.notify_all();
+    writer_.join();
+    file_.close();
+}
+
+void Logger::setLevel(Level level) {
+    level_ = level;
+}
+
+bool Logger::enabled(Level level) const {
+    return open_.load(std::memory_order_relaxed) && level >= level_.load(std::memory_order_relaxed);
+}
+
+/*
+ * Adds a message to the ring buffer, every slot has a sequence number that tells writers and the reader whether it is
+ * free or holds a message.
+ *
+ * Source: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ */
+void Logger::push(std::string message) {
+    auto position = head_.load(std::memory_order_relaxed);
+    Slot *slot;
+
+    while (true) {
+        slot = &slots_[position & (LOG_BUFFER_SIZE - 1)];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+        if (difference == 0) {
+            if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (difference < 0) {
+            // the buffer is full, the engine must never wait for the log
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->message = std::move(message);
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+/*
+ * Writes all messages that are in the ring buffer to the file, and flushes the file once.
+ */
+void Logger::drain() {
+    while (true) {
+        auto &slot = slots_[tail_ & (LOG_BUFFER_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != tail_ + 1)
+            break;
+
+        file_ << slot.message << '\n';
+        slot.message.clear();
+        slot.sequence.store(tail_ + LOG_BUFFER_SIZE, std::memory_order_release);
+        tail_++;
+    }
+
+    if (auto dropped = dropped_.exchange(0, std::memory_order_relaxed); dropped > 0)
+        file_ << "(" << dropped << " log messages dropped)\n";
+
+    file_.flush();
+}
+
+void Logger::writeLoop() {
+    std::unique_lock lock(writerMutex_);
+    bool stop = false;
+
+    // the messages that are buffered when the writer is stopped are written as well
+    while (!stop) {
+        stop = writerCondition_.wait_for(lock, std::chrono::milliseconds(LOG_FLUSH_INTERVAL), [this] {
+            return stopWriter_;
+        });
+        drain();
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CHESS_ENGINE_LOGGER_HPP
+#define CHESS_ENGINE_LOGGER_HPP
+
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Asynchronous log file.
+ *
+ * Any thread can write messages, they are put in a lock-free ring buffer and written to the file in batches by a
+ * background thread, so writing a message never waits for the disk. Messages are dropped when the buffer is full.
+ * Messages below the log level, or written while no file is open, are discarded before they are formatted.
+ */
+class Logger {
+public:
+
+    enum class Level {
+        Debug,
+        Info,
+        Error
+    };
+
+    Logger();
+
+    ~Logger();
+
+    Logger(const Logger &) = delete;
+
+    Logger &operator=(const Logger &) = delete;
+
+    bool open(const std::string &path);
+
+    void close();
+
+    void setLevel(Level level);
+
+    [[nodiscard]] bool enabled(Level level) const;
+
+    template<typename... Args>
+    void write(Level level, const Args &...args) {
+        if (!enabled(level))
+            return;
+
+        std::ostringstream stream;
+        (stream << ... << args);
+        push(stream.str());
+    }
+
+private:
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::string message;
+    };
+
+    void push(std::string message);
+
+    void writeLoop();
+
+    void drain();
+
+    std::unique_ptr<Slot[]> slots_;
+
+    // position of the next message that is written and of the next message that is read by the writer thread
+    std::atomic<std::size_t> head_ = 0;
+    std::size_t tail_ = 0;
+
+    std::atomic<Level> level_ = Level::Debug;
+    std::atomic<bool> open_ = false;
+    std::atomic<uint64_t> dropped_ = 0;
+
+    std::ofstream file_;
+    std::thread writer_;
+    std::mutex writerMutex_;
+    std::condition_variable writerCondition_;
+    bool stopWriter_ = false;
+};
+
+#endif
@@ -2,12 +2,156 @@
 #include "EngineFactory.hpp"
 #include "Fen.hpp"
 #include "Engine.hpp"
+#include "Batch.hpp"
+#include "Nnue.hpp"
+
+#ifdef PENGUIN_SERVER
+#include "Server.hpp"
+#endif
 
 #include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
 #include <cstdlib>
+#include <optional>
+#include <algorithm>
+
+/*
+ * Analyses all positions of the given EPD or lichess puzzle CSV files and writes one line of JSON per position to
+ * stdout. Results are written in the order in which they finish, the index of a result is the number of the position
+ * in the input.
+ *
+ * Usage: penguin --batch [--threads=N] [--depth=N] [--nodes=N] [--movetime=MS] file...
+ */
+static int batch(int argc, char* argv[]) {
+    SearchLimits limits;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> files;
+
+    for (int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg.starts_with("--threads=")) {
+            threads = std::atoi(arg.c_str() + 10);
+        } else if (arg.starts_with("--depth=")) {
+            limits.depth = std::atoi(arg.c_str() + 8);
+        } else if (arg.starts_with("--nodes=")) {
+            limits.nodes = std::strtoull(arg.c_str() + 8, nullptr, 10);
+        } else if (arg.starts_with("--movetime=")) {
+            limits.moveTime = std::chrono::milliseconds(std::atoi(arg.c_str() + 11));
+        } else if (arg.starts_with("--")) {
+            std::cerr << "Unknown option " << arg << '\n';
+            return EXIT_FAILURE;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        std::cerr << "Usage: penguin --batch [--threads=N] [--depth=N] [--nodes=N] [--movetime=MS] file...\n";
+        return EXIT_FAILURE;
+    }
+
+    auto analyser = Batch::Analyser(threads, limits, [](const Batch::Result &result) {
+        std::cout << Batch::toJson(result) << '\n';
+    });
+
+    std::size_t index = 0;
+
+    for (const auto &path : files) {
+        std::ifstream file(path);
+
+        if (!file) {
+            std::cerr << "Cannot open " << path << '\n';
+            return EXIT_FAILURE;
+        }
+
+        auto format = Batch::formatOf(path);
+        auto lineNumber = 0;
+
+        for (std::string line; std::getline(file, line);) {
+            lineNumber++;
+
+            if (auto position = Batch::parseLine(line, format, index); position.has_value()) {
+                analyser.add(std::move(position.value()));
+                index++;
+            } else if (!line.empty() && line.front() != '#' && !line.starts_with("PuzzleId,")) {
+                std::cerr << path << ':' << lineNumber << ": not a position\n";
+            }
+        }
+    }
+
+    analyser.finish();
+    std::cout.flush();
+    return EXIT_SUCCESS;
+}
+
+#ifdef PENGUIN_SERVER
+/*
+ * Serves UCI sessions over a Unix domain socket or a TCP port on localhost until the process is killed. The searches of
+ * all sessions share a pool of threads, which defaults to one thread per core.
+ *
+ * Usage: penguin --server (--socket=PATH | --port=N) [--threads=N] [--evalfile=PATH]
+ */
+static int server(int argc, char* argv[]) {
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string socketPath, evalFile;
+    std::optional<int> port;
+
+    for (int i = 0; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg.starts_with("--threads=")) {
+            threads = std::atoi(arg.c_str() + 10);
+        } else if (arg.starts_with("--socket=")) {
+            socketPath = arg.substr(9);
+        } else if (arg.starts_with("--port=")) {
+            port = std::atoi(arg.c_str() + 7);
+        } else if (arg.starts_with("--evalfile=")) {
+            evalFile = arg.substr(11);
+        } else {
+            std::cerr << "Unknown option " << arg << '\n';
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (socketPath.empty() == !port.has_value() || port.value_or(0) < 0 || port.value_or(0) > 65535) {
+        std::cerr << "Usage: penguin --server (--socket=PATH | --port=N) [--threads=N] [--evalfile=PATH]\n";
+        return EXIT_FAILURE;
+    }
+
+    // the network is shared by all sessions
+    if (!evalFile.empty() && !Nnue::load(evalFile)) {
+        std::cerr << "Cannot load " << evalFile << '\n';
+        return EXIT_FAILURE;
+    }
+
+    auto server = Server(threads);
+    auto listening = port.has_value() ? server.listenTcp(port.value()) : server.listenUnix(socketPath);
+
+    if (!listening) {
+        std::cerr << "Cannot listen on " << (port.has_value() ? std::to_string(port.value()) : socketPath) << '\n';
+        return EXIT_FAILURE;
+    }
+
+    server.run();
+    return EXIT_SUCCESS;
+}
+#endif
 
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return batch(argc - 2, argv + 2);
+    }
+
+#ifdef PENGUIN_SERVER
+    if (argc > 1 && std::string(argv[1]) == "--server") {
+        return server(argc - 2, argv + 2);
+    }
+#endif
+
     auto engine = EngineFactory::createEngine();
 
     if (engine == nullptr) {
@@ -27,8 +171,7 @@ int main(int argc, char* argv[]) {
         auto pv = engine->pv(board.value());
         std::cout << "PV: " << pv << '\n';
     } else {
-        auto uciLog = std::ofstream("uci-log.txt");
-        auto uci = Uci(std::move(engine), std::cin, std::cout, uciLog);
+        auto uci = Uci(std::move(engine), std::cin, std::cout);
         uci.run();
     }
 }
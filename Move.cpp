@@ -4,7 +4,7 @@
 Move::Move(const Square &from, const Square &to,
            const std::optional<PieceType> &promotion) : from_(from), to_(to), promotion_(promotion) {}
 
-Move::Optional Move::fromUci(const std::string &uci) {
+Move::Optional Move::fromUci(std::string_view uci) {
     if (uci.length() < 4 || uci.length() > 5) {
         return std::nullopt;
     }
@@ -28,6 +28,19 @@ Move::Optional Move::fromUci(const std::string &uci) {
     return Move(from.value(), to.value(), promotion);
 }
 
+/*
+ * Returns the move in the notation used by UCI, e.g. "e2e4" or "e7e8q".
+ */
+std::string Move::toUci() const {
+    auto uci = from_.toName() + to_.toName();
+
+    if (promotion_) {
+        uci += Piece(PieceColor::Black, promotion_.value()).toSymbol();
+    }
+
+    return uci;
+}
+
 Square Move::from() const {
     return from_;
 }
@@ -7,6 +7,7 @@
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <string_view>
 
 class Board;
 
@@ -19,7 +20,9 @@ public:
     Move(const Square& from, const Square& to,
          const std::optional<PieceType>& promotion = std::nullopt);
 
-    static Optional fromUci(const std::string& uci);
+    static Optional fromUci(std::string_view uci);
+
+    [[nodiscard]] std::string toUci() const;
 
     [[nodiscard]] Square from() const;
     [[nodiscard]] Square to() const;
@@ -6,6 +6,22 @@
 #include "Board.hpp"
 #include "MoveGenerator.h"
 
+#include <bit>
+#include <vector>
+#include <memory>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// PEXT is compiled in on x86-64 with GCC or Clang, and only used if the CPU supports it
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define PEXT_DISPATCH
+#include <immintrin.h>
+#endif
+
 // macros for the files and ranks
 #define FILE_A 0x0101010101010101L
 #define FILE_B 0x0202020202020202L
@@ -31,6 +47,56 @@
 
 using U64 = uint64_t;
 
+/*
+ * Returns the squares attacked by all knights in the given bitboard.
+ * Source: https://www.chessprogramming.org/Knight_Pattern
+ */
+static constexpr U64 knightSet(U64 knights) {
+    U64 l1 = (knights >> 1) & U64(0x7f7f7f7f7f7f7f7fL);
+    U64 l2 = (knights >> 2) & U64(0x3f3f3f3f3f3f3f3fL);
+    U64 r1 = (knights << 1) & U64(0xfefefefefefefefeL);
+    U64 r2 = (knights << 2) & U64(0xfcfcfcfcfcfcfcfcL);
+    U64 h1 = l1 | r1;
+    U64 h2 = l2 | r2;
+    return (h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8);
+}
+
+/*
+ * Returns the squares attacked by all kings in the given bitboard.
+ * Source: https://www.chessprogramming.org/King_Pattern
+ */
+static constexpr U64 kingSet(U64 kings) {
+    U64 sides = ((kings << 1) & ~U64(FILE_A)) | ((kings >> 1) & ~U64(FILE_H));
+    U64 row = kings | sides;
+    return sides | (row << 8) | (row >> 8);
+}
+
+/*
+ * Attacks of the leaping pieces from every square, generated at compile time.
+ * Pawn attacks are indexed by color first, white 0 and black 1.
+ */
+struct LeaperTables {
+    U64 knight[NSQ];
+    U64 king[NSQ];
+    U64 pawn[2][NSQ];
+};
+
+static constexpr LeaperTables makeLeaperTables() {
+    LeaperTables tables{};
+
+    for (int sq = 0; sq < NSQ; sq++) {
+        U64 piece = bit << sq;
+        tables.knight[sq] = knightSet(piece);
+        tables.king[sq] = kingSet(piece);
+        tables.pawn[0][sq] = ((piece << 9) & ~U64(FILE_A)) | ((piece << 7) & ~U64(FILE_H));
+        tables.pawn[1][sq] = ((piece >> 7) & ~U64(FILE_A)) | ((piece >> 9) & ~U64(FILE_H));
+    }
+
+    return tables;
+}
+
+static constexpr LeaperTables leapers = makeLeaperTables();
+
 /*
  * Generates all pseudo-legal King moves according to the given board state and from the given square.
  *
@@ -43,84 +109,59 @@ using U64 = uint64_t;
  */
 U64 MoveGenerator::kingMoves(const Board &board, const Square &square, const U64 &empty, const U64 &enemy, bool allowCastling) {
     auto idx = square.index();
-    auto mask = bit << idx;
-    U64 moves = 0UL;
 
     // REGULAR MOVES //
-    // new moves only get added if they stay within the board
-
-    // up
-    if (idx < 56)
-        moves |= mask << 8;
-
-    // down
-    if (idx > 7)
-        moves |= mask >> 8;
-
-    // left
-    if (idx % 8 != 0)
-        moves |= mask >> 1;
-
-    // right
-    if (idx % 8 != 7)
-        moves |= mask << 1;
-
-    // up-left
-    if (idx < 56 && idx % 8 != 0)
-        moves |= mask << 7;
-
-    // up-right
-    if (idx < 56 && idx % 8 != 7)
-        moves |= mask << 9;
-
-    // down-left
-    if (idx > 7 && idx % 8 != 0)
-        moves |= mask >> 9;
-
-    // down-right
-    if (idx > 7 && idx % 8 != 7)
-        moves |= mask >> 7;
+    U64 moves = leapers.king[idx];
 
     // CASTLING MOVES //
     if (allowCastling) {
-        // bitboard with all enemy controlled squares
-        // a king cannot castle if it is in check or if it passes through a square that is under attack
-        U64 enemyControlled = board.getEnemyControlledSquares(board.turn());
-
-        // different squares need to be checked depending on the color of the king
-        // all these long (unreadable) if statements check whether the king has castling rights and whether the squares
-        // it passes through are under attack
-        switch (board.turn()) {
-            case PieceColor::White:
-                if ((board.castlingRights() & CastlingRights::WhiteKingside) == CastlingRights::WhiteKingside &&
-                    (empty & 0x60) == 0x60 &&
-                    (enemyControlled & 0x70) == 0)
-                    moves |= 0x40;
-
-                if ((board.castlingRights() & CastlingRights::WhiteQueenside) == CastlingRights::WhiteQueenside &&
-                    (empty & 0xE) == 0xE &&
-                    (enemyControlled & 0x1C) == 0)
-                    moves |= 0x4;
-
-                break;
-            case PieceColor::Black:
-                if ((board.castlingRights() & CastlingRights::BlackKingside) == CastlingRights::BlackKingside &&
-                    (empty & 0x6000000000000000) == 0x6000000000000000 &&
-                    (enemyControlled & 0x7000000000000000) == 0)
-                    moves |= 0x4000000000000000;
-
-                if ((board.castlingRights() & CastlingRights::BlackQueenside) == CastlingRights::BlackQueenside &&
-                    (empty & 0xE00000000000000) == 0xE00000000000000 &&
-                    (enemyControlled & 0x1C00000000000000) == 0)
-                    moves |= 0x400000000000000;
-                break;
-        }
+        if (board.turn() == PieceColor::White)
+            moves |= castlingMoves<PieceColor::White>(board, empty);
+        else
+            moves |= castlingMoves<PieceColor::Black>(board, empty);
     }
 
     // return only those moves that land on either an empty square or an enemy square (i.e., not on a friendly square)
     return moves & (empty | enemy);
 }
 
+/*
+ * Generates the castling moves of the king of color `Us`, which must be the side to move.
+ *
+ * A king cannot castle if it is in check or if it passes through a square that is under attack, and all squares
+ * between the king and the rook must be empty.
+ */
+template<PieceColor Us>
+U64 MoveGenerator::castlingMoves(const Board &board, U64 empty) {
+    constexpr bool white = Us == PieceColor::White;
+    constexpr auto kingside = white ? CastlingRights::WhiteKingside : CastlingRights::BlackKingside;
+    constexpr auto queenside = white ? CastlingRights::WhiteQueenside : CastlingRights::BlackQueenside;
+    // the masks are given for white and moved to the back rank of black
+    constexpr int shift = white ? 0 : 56;
+
+    auto cr = board.castlingRights();
+    if ((cr & (kingside | queenside)) == CastlingRights::None)
+        return 0UL;
+
+    U64 enemyControlled = board.attackInfo().attacked[white ? 1 : 0];
+    U64 moves = 0UL;
+
+    if ((cr & kingside) == kingside &&
+        (empty & (0x60UL << shift)) == (0x60UL << shift) &&
+        (enemyControlled & (0x70UL << shift)) == 0)
+        moves |= 0x40UL << shift;
+
+    if ((cr & queenside) == queenside &&
+        (empty & (0xEUL << shift)) == (0xEUL << shift) &&
+        (enemyControlled & (0x1CUL << shift)) == 0)
+        moves |= 0x4UL << shift;
+
+    return moves;
+}
+
+template U64 MoveGenerator::castlingMoves<PieceColor::White>(const Board &board, U64 empty);
+template U64 MoveGenerator::castlingMoves<PieceColor::Black>(const Board &board, U64 empty);
+
 /*
  * Generates all pseudo-legal Queen moves from the given square.
  *
@@ -135,14 +176,14 @@ U64 MoveGenerator::queenMoves(const Square &square, const U64 &empty, const U64
 }
 
 /*
- * Generates all pseudo-legal Rook moves from the given square.
+ * Generates all pseudo-legal Rook moves from the given square, ray by ray.
  *
  * Parameters:
  * - square: the square from which to generate moves
  * - empty: a bitboard representing empty squares
  * - enemy: a bitboard representing enemy pieces
  */
-U64 MoveGenerator::rookMoves(const Square &square, const U64 &empty, const U64 &enemy) {
+static U64 rookRays(const Square &square, const U64 &empty, const U64 &enemy) {
     U64 rookMoves = 0UL;
     U64 rook = bit << square.index();
     U64 rookMovesMask;
@@ -195,14 +236,14 @@ U64 MoveGenerator::rookMoves(const Square &square, const U64 &empty, const U64 &
 }
 
 /*
- * Generates all pseudo-legal Bishop moves from the given square.
+ * Generates all pseudo-legal Bishop moves from the given square, ray by ray.
  *
  * Parameters:
  * - square: the square from which to generate moves
  * - empty: a bitboard representing empty squares
  * - enemy: a bitboard representing enemy pieces
  */
-U64 MoveGenerator::bishopMoves(const Square &square, const U64 &empty, const U64 &enemy) {
+static U64 bishopRays(const Square &square, const U64 &empty, const U64 &enemy) {
     U64 bishopMoves = 0UL;
     U64 bishop = bit << square.index();
     U64 bishopMovesMask;
@@ -254,6 +295,154 @@ U64 MoveGenerator::bishopMoves(const Square &square, const U64 &empty, const U64
     return bishopMoves;
 }
 
+/*
+ * Slider attack tables indexed with PEXT: for every square, the occupancy of the squares that can block the slider
+ * (the relevant mask) is compressed into a dense index into that square's part of the table.
+ *
+ * Source: https://www.chessprogramming.org/BMI2#PEXTBitboards
+ */
+struct PextTable {
+    U64 masks[NSQ];
+    unsigned offsets[NSQ];
+    std::vector<U64> attacks;
+
+    PextTable(U64 (*rays)(const Square &, const U64 &, const U64 &)) {
+        unsigned size = 0;
+
+        for (unsigned sq = 0; sq < NSQ; sq++) {
+            auto square = Square(sq);
+
+            // pieces on the edge of the board never block a ray, unless the slider is on that edge itself
+            U64 edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * square.rank()))) |
+                        ((FILE_A | FILE_H) & ~(FILE_A << square.file()));
+            masks[sq] = rays(square, ~0UL, 0UL) & ~edges;
+            offsets[sq] = size;
+            size += 1U << std::popcount(masks[sq]);
+        }
+
+        attacks.resize(size);
+
+        for (unsigned sq = 0; sq < NSQ; sq++) {
+            auto square = Square(sq);
+
+            // enumerate all subsets of the mask, Carry-Rippler trick
+            U64 occupied = 0UL;
+            do {
+                attacks[offsets[sq] + extract(occupied, masks[sq])] = rays(square, ~occupied, occupied);
+                occupied = (occupied - masks[sq]) & masks[sq];
+            } while (occupied);
+        }
+    }
+
+    // software version of PEXT, only used to fill the table
+    static U64 extract(U64 bitboard, U64 mask) {
+        U64 result = 0UL;
+        for (U64 i = 1; mask; i <<= 1, mask &= mask - 1) {
+            if (bitboard & mask & -mask)
+                result |= i;
+        }
+        return result;
+    }
+};
+
+#if defined(PEXT_DISPATCH)
+
+// the tables are only built once the PEXT backend is selected
+static std::unique_ptr<PextTable> rookTable, bishopTable;
+
+__attribute__((target("bmi2")))
+static U64 pextAttacks(const PextTable &table, unsigned square, U64 occupied) {
+    return table.attacks[table.offsets[square] + _pext_u64(occupied, table.masks[square])];
+}
+
+#endif
+
+static MoveGenerator::SliderBackend initialBackend() {
+    if (MoveGenerator::pextSupported()) {
+#if defined(PEXT_DISPATCH)
+        rookTable = std::make_unique<PextTable>(rookRays);
+        bishopTable = std::make_unique<PextTable>(bishopRays);
+#endif
+        return MoveGenerator::SliderBackend::Pext;
+    }
+
+    return MoveGenerator::SliderBackend::Loop;
+}
+
+static MoveGenerator::SliderBackend backend = initialBackend();
+
+/*
+ * Generates all pseudo-legal Rook moves from the given square, using the selected slider backend.
+ *
+ * Parameters:
+ * - square: the square from which to generate moves
+ * - empty: a bitboard representing empty squares
+ * - enemy: a bitboard representing enemy pieces
+ */
+U64 MoveGenerator::rookMoves(const Square &square, const U64 &empty, const U64 &enemy) {
+#if defined(PEXT_DISPATCH)
+    if (backend == SliderBackend::Pext)
+        return pextAttacks(*rookTable, square.index(), ~empty) & (empty | enemy);
+#endif
+    return rookRays(square, empty, enemy);
+}
+
+/*
+ * Generates all pseudo-legal Bishop moves from the given square, using the selected slider backend.
+ *
+ * Parameters:
+ * - square: the square from which to generate moves
+ * - empty: a bitboard representing empty squares
+ * - enemy: a bitboard representing enemy pieces
+ */
+U64 MoveGenerator::bishopMoves(const Square &square, const U64 &empty, const U64 &enemy) {
+#if defined(PEXT_DISPATCH)
+    if (backend == SliderBackend::Pext)
+        return pextAttacks(*bishopTable, square.index(), ~empty) & (empty | enemy);
+#endif
+    return bishopRays(square, empty, enemy);
+}
+
+/*
+ * Returns whether the CPU supports the PEXT instruction (BMI2). This is checked at runtime, so the same binary also
+ * runs on older CPUs.
+ */
+bool MoveGenerator::pextSupported() {
+#if defined(PEXT_DISPATCH)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#else
+    return false;
+#endif
+}
+
+/*
+ * Selects the implementation used to generate slider moves. By default, PEXT is used when the CPU supports it.
+ * Returns false if the backend is not supported on this CPU, in which case the current backend is kept.
+ */
+bool MoveGenerator::setSliderBackend(SliderBackend backend) {
+    if (backend == SliderBackend::Pext && !pextSupported())
+        return false;
+
+#if defined(PEXT_DISPATCH)
+    if (backend == SliderBackend::Pext && !rookTable) {
+        rookTable = std::make_unique<PextTable>(rookRays);
+        bishopTable = std::make_unique<PextTable>(bishopRays);
+    }
+#endif
+
+    ::backend = backend;
+    return true;
+}
+
+MoveGenerator::SliderBackend MoveGenerator::sliderBackend() {
+    return backend;
+}
+
+std::string MoveGenerator::sliderBackendName() {
+    return backend == SliderBackend::Pext ? "pext" : "loop";
+}
+
 /*
  * Generates all pseudo-legal Knight moves from the given square.
  *
@@ -265,14 +454,7 @@ U64 MoveGenerator::bishopMoves(const Square &square, const U64 &empty, const U64
  * - enemy: a bitboard representing enemy pieces
  */
 U64 MoveGenerator::knightMoves(const Square &square, const U64 &empty, const U64 &enemy) {
-    U64 knight = bit << square.index();
-    U64 l1 = (knight >> 1) & U64(0x7f7f7f7f7f7f7f7fL);
-    U64 l2 = (knight >> 2) & U64(0x3f3f3f3f3f3f3f3fL);
-    U64 r1 = (knight << 1) & U64(0xfefefefefefefefeL);
-    U64 r2 = (knight << 2) & U64(0xfcfcfcfcfcfcfcfcL);
-    U64 h1 = l1 | r1;
-    U64 h2 = l2 | r2;
-    return ((h1 << 16) | (h1 >> 16) | (h2 << 8) | (h2 >> 8)) & (empty | enemy);
+    return leapers.knight[square.index()] & (empty | enemy);
 }
 
 /*
@@ -330,21 +512,212 @@ U64 MoveGenerator::pawnMoves(const Square &square, const U64 &empty, const U64 &
 }
 
 U64 MoveGenerator::pawnAttacks(const Square &square, const PieceColor turn) {
+    return leapers.pawn[turn == PieceColor::White ? 0 : 1][square.index()];
+}
 
-    U64 moves = 0UL;
-    U64 pawn = bit << square.index();
+/*
+ * Generates the Knight attacks of all knights in the given bitboard at once.
+ *
+ * Source: https://www.chessprogramming.org/Knight_Pattern
+ */
+U64 MoveGenerator::knightAttacks(U64 knights) {
+    return knightSet(knights);
+}
 
-    if (turn == PieceColor::White) {
+/*
+ * The eight sliding directions, as a shift and a mask that removes the squares that wrapped around the board.
+ * Positive shifts go up the board, negative shifts go down. The first four directions are straight, the last four
+ * diagonal.
+ */
+struct Direction {
+    int shift;
+    U64 mask;
+};
+
+static const Direction directions[8] = {
+        {8,  ~0UL},
+        {1,  ~U64(FILE_A)},
+        {-8, ~0UL},
+        {-1, ~U64(FILE_H)},
+        {9,  ~U64(FILE_A)},
+        {7,  ~U64(FILE_H)},
+        {-7, ~U64(FILE_A)},
+        {-9, ~U64(FILE_H)}
+};
+
+#if defined(__AVX2__)
+
+/*
+ * Kogge-Stone fills of one set of sliders, four directions per vector: straight sliders in the first two lanes and
+ * diagonal sliders in the last two, once for the directions going up and once for those going down.
+ */
+static void koggeStone(U64 straight, U64 diagonal, U64 empty, U64 &straightAttacks, U64 &diagonalAttacks) {
+    const auto s1 = _mm256_setr_epi64x(8, 1, 9, 7);
+    const auto s2 = _mm256_setr_epi64x(16, 2, 18, 14);
+    const auto s4 = _mm256_setr_epi64x(32, 4, 36, 28);
+    const auto upMask = _mm256_setr_epi64x(~0L, ~FILE_A, ~FILE_A, ~FILE_H);
+    const auto downMask = _mm256_setr_epi64x(~0L, ~FILE_H, ~FILE_A, ~FILE_H);
+
+    auto generator = _mm256_setr_epi64x(straight, straight, diagonal, diagonal);
+    auto free = _mm256_set1_epi64x(empty);
+
+    // up: north, east, north-east, north-west
+    auto gen = generator;
+    auto pro = _mm256_and_si256(free, upMask);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, s1)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, s1));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, s2)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, s2));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sllv_epi64(gen, s4)));
+    auto up = _mm256_and_si256(_mm256_sllv_epi64(gen, s1), upMask);
+
+    // down: south, west, south-east, south-west
+    const auto d1 = _mm256_setr_epi64x(8, 1, 7, 9);
+    const auto d2 = _mm256_setr_epi64x(16, 2, 14, 18);
+    const auto d4 = _mm256_setr_epi64x(32, 4, 28, 36);
+
+    gen = generator;
+    pro = _mm256_and_si256(free, downMask);
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, d1)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, d1));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, d2)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, d2));
+    gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srlv_epi64(gen, d4)));
+    auto down = _mm256_and_si256(_mm256_srlv_epi64(gen, d1), downMask);
+
+    alignas(32) U64 lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), _mm256_or_si256(up, down));
+
+    straightAttacks = lanes[0] | lanes[1];
+    diagonalAttacks = lanes[2] | lanes[3];
+}
 
-        moves |= (pawn << 9) & ~FILE_A;
-        moves |= (pawn << 7) & ~FILE_H;
+#elif defined(__SSE2__)
 
+/*
+ * Kogge-Stone fill in one direction of two sets of sliders, one per lane.
+ */
+static __m128i koggeStone(__m128i gen, U64 empty, const Direction &direction) {
+    const auto mask = _mm_set1_epi64x(direction.mask);
+    auto pro = _mm_and_si128(_mm_set1_epi64x(empty), mask);
+
+    auto amount = direction.shift > 0 ? direction.shift : -direction.shift;
+    const auto s1 = _mm_cvtsi32_si128(amount);
+    const auto s2 = _mm_cvtsi32_si128(amount * 2);
+    const auto s4 = _mm_cvtsi32_si128(amount * 4);
+
+    if (direction.shift > 0) {
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_sll_epi64(gen, s1)));
+        pro = _mm_and_si128(pro, _mm_sll_epi64(pro, s1));
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_sll_epi64(gen, s2)));
+        pro = _mm_and_si128(pro, _mm_sll_epi64(pro, s2));
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_sll_epi64(gen, s4)));
+        return _mm_and_si128(_mm_sll_epi64(gen, s1), mask);
     } else {
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_srl_epi64(gen, s1)));
+        pro = _mm_and_si128(pro, _mm_srl_epi64(pro, s1));
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_srl_epi64(gen, s2)));
+        pro = _mm_and_si128(pro, _mm_srl_epi64(pro, s2));
+        gen = _mm_or_si128(gen, _mm_and_si128(pro, _mm_srl_epi64(gen, s4)));
+        return _mm_and_si128(_mm_srl_epi64(gen, s1), mask);
+    }
+}
 
-        moves |= (pawn >> 7) & ~FILE_A;
-        moves |= (pawn >> 9) & ~FILE_H;
+#else
 
+static U64 shift(U64 bitboard, int amount) {
+    return amount > 0 ? bitboard << amount : bitboard >> -amount;
+}
+
+/*
+ * Kogge-Stone fill of a set of sliders in one direction.
+ */
+static U64 koggeStone(U64 gen, U64 empty, const Direction &direction) {
+    auto s = direction.shift;
+    U64 pro = empty & direction.mask;
+
+    gen |= pro & shift(gen, s);
+    pro &= shift(pro, s);
+    gen |= pro & shift(gen, 2 * s);
+    pro &= shift(pro, 2 * s);
+    gen |= pro & shift(gen, 4 * s);
+
+    return shift(gen, s) & direction.mask;
+}
+
+#endif
+
+/*
+ * Generates the attacks of two independent sets of sliders at once, e.g., the sliders of both colors.
+ *
+ * `straight` sliders move along ranks and files and `diagonal` sliders along diagonals, a queen is both. The attacks
+ * of all sliders of a set are computed together with Kogge-Stone occluded fills, so the cost does not depend on the
+ * number of pieces. With AVX2, four directions are filled per instruction, with SSE2 the two sets share one.
+ * Sliders attack up to and including the first piece on each ray.
+ *
+ * Source: https://www.chessprogramming.org/Kogge-Stone_Algorithm
+ */
+void MoveGenerator::slidingAttacks(const U64 straight[2], const U64 diagonal[2], U64 empty,
+                                   U64 straightAttacks[2], U64 diagonalAttacks[2]) {
+#if defined(__AVX2__)
+    for (int i = 0; i < 2; i++)
+        koggeStone(straight[i], diagonal[i], empty, straightAttacks[i], diagonalAttacks[i]);
+#elif defined(__SSE2__)
+    auto straightGen = _mm_set_epi64x(straight[1], straight[0]);
+    auto diagonalGen = _mm_set_epi64x(diagonal[1], diagonal[0]);
+
+    auto straightAcc = _mm_setzero_si128();
+    auto diagonalAcc = _mm_setzero_si128();
+    for (int i = 0; i < 4; i++) {
+        straightAcc = _mm_or_si128(straightAcc, koggeStone(straightGen, empty, directions[i]));
+        diagonalAcc = _mm_or_si128(diagonalAcc, koggeStone(diagonalGen, empty, directions[i + 4]));
     }
 
-    return moves;
-}
\ No newline at end of file
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(straightAttacks), straightAcc);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(diagonalAttacks), diagonalAcc);
+#else
+    for (int i = 0; i < 2; i++) {
+        straightAttacks[i] = 0UL;
+        diagonalAttacks[i] = 0UL;
+        for (int j = 0; j < 4; j++) {
+            straightAttacks[i] |= koggeStone(straight[i], empty, directions[j]);
+            diagonalAttacks[i] |= koggeStone(diagonal[i], empty, directions[j + 4]);
+        }
+    }
+#endif
+}
+
+/*
+ * Same as `slidingAttacks`, but generates the attacks of every slider separately, ray by ray.
+ * Used as a reference for testing and benchmarking.
+ */
+void MoveGenerator::slidingAttacksPerSquare(const U64 straight[2], const U64 diagonal[2], U64 empty,
+                                            U64 straightAttacks[2], U64 diagonalAttacks[2]) {
+    for (int i = 0; i < 2; i++) {
+        straightAttacks[i] = 0UL;
+        diagonalAttacks[i] = 0UL;
+
+        for (U64 pieces = straight[i]; pieces; pieces &= pieces - 1) {
+            auto square = Square(std::countr_zero(pieces));
+            straightAttacks[i] |= rookMoves(square, empty, ~empty);
+        }
+
+        for (U64 pieces = diagonal[i]; pieces; pieces &= pieces - 1) {
+            auto square = Square(std::countr_zero(pieces));
+            diagonalAttacks[i] |= bishopMoves(square, empty, ~empty);
+        }
+    }
+}
+
+/*
+ * Returns the name of the instruction set used by `slidingAttacks`.
+ */
+const char *MoveGenerator::slidingAttacksImplementation() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
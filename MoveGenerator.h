@@ -8,6 +8,8 @@
 
 #include "Board.hpp"
 
+#include <string>
+
 class MoveGenerator {
 
 public:
@@ -16,7 +18,16 @@ public:
     using MoveVec = std::vector<Move>;
     using U64 = uint64_t;
 
+    enum class SliderBackend {
+        Loop,
+        Pext
+    };
+
     static U64 kingMoves(const Board &board, const Square &square, const U64 &empty, const U64 &enemy, bool allowCastling);
+
+    template<PieceColor Us>
+    static U64 castlingMoves(const Board &board, U64 empty);
+
     static U64 queenMoves(const Square &square, const U64 &empty, const U64 &enemy);
     static U64 rookMoves(const Square &square, const U64 &empty, const U64 &enemy);
     static U64 bishopMoves(const Square &square, const U64 &empty, const U64 &enemy);
@@ -24,6 +35,21 @@ public:
     static U64 pawnMoves(const Square &square, const U64 &empty, const U64 &enemy, const PieceColor &turn, const std::optional<Square> &epsq);
 
     static U64 pawnAttacks(const Square &square, PieceColor turn);
+
+    static U64 knightAttacks(U64 knights);
+
+    static void slidingAttacks(const U64 straight[2], const U64 diagonal[2], U64 empty,
+                               U64 straightAttacks[2], U64 diagonalAttacks[2]);
+
+    static void slidingAttacksPerSquare(const U64 straight[2], const U64 diagonal[2], U64 empty,
+                                        U64 straightAttacks[2], U64 diagonalAttacks[2]);
+
+    static const char *slidingAttacksImplementation();
+
+    static bool pextSupported();
+    static bool setSliderBackend(SliderBackend backend);
+    static SliderBackend sliderBackend();
+    static std::string sliderBackendName();
 };
 
 
@@ -0,0 +1,320 @@
+#include "Nnue.hpp"
+
+#include <fstream>
+#include <memory>
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define CLIP 127 // accumulator values are clipped to [0, CLIP] before the output layer
+#define OUTPUT_SCALE 16 // the output of the network divided by OUTPUT_SCALE is the score in centipawns
+#define MAX_HIDDEN 4096
+
+namespace {
+
+    struct Network {
+        int hidden = 0;
+        std::vector<int16_t> featureBiases;
+        std::vector<int16_t> featureWeights;
+        // stored as int16 so the output layer can multiply them with the accumulators directly
+        std::vector<int16_t> outputWeights;
+        int32_t outputBias = 0;
+    };
+
+    // the network is shared by all engines and only changed between searches
+    std::unique_ptr<Network> network;
+
+    // incremented every time a network is loaded, so cached scores of a previous network are never used
+    uint64_t networkCount = 0;
+
+    template<typename T>
+    bool read(std::istream &stream, T *values, std::size_t count) {
+        stream.read(reinterpret_cast<char *>(values), static_cast<std::streamsize>(sizeof(T) * count));
+        return static_cast<bool>(stream);
+    }
+
+    /*
+     * Returns the index of the feature for a piece of the given bitboard on the given square, as seen from the given
+     * perspective. Black sees the board flipped with the colors of the pieces swapped.
+     */
+    int featureIndex(int perspective, unsigned kingSquare, int bitboard, unsigned square) {
+        if (perspective == 1) {
+            kingSquare ^= 56;
+            square ^= 56;
+            bitboard = (bitboard + 6) % 12;
+        }
+
+        return static_cast<int>((kingSquare * 12 + bitboard) * 64 + square);
+    }
+
+    unsigned kingSquare(const Board &board, int perspective) {
+        auto king = board.getBitboards()[perspective == 0 ? 0 : 6];
+        return king ? std::countr_zero(king) : 0;
+    }
+
+    /*
+     * Vector kernels. The hidden size is a multiple of 16, so no remainder loops are needed.
+     */
+    void addRow(int16_t *accumulator, const int16_t *row, int n) {
+#if defined(__AVX2__)
+        for (int i = 0; i < n; i += 16) {
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(accumulator + i));
+            auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(accumulator + i), _mm256_add_epi16(a, r));
+        }
+#elif defined(__SSE2__)
+        for (int i = 0; i < n; i += 8) {
+            auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(accumulator + i));
+            auto r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(accumulator + i), _mm_add_epi16(a, r));
+        }
+#else
+        for (int i = 0; i < n; i++)
+            accumulator[i] = static_cast<int16_t>(accumulator[i] + row[i]);
+#endif
+    }
+
+    void subRow(int16_t *accumulator, const int16_t *row, int n) {
+#if defined(__AVX2__)
+        for (int i = 0; i < n; i += 16) {
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(accumulator + i));
+            auto r = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(accumulator + i), _mm256_sub_epi16(a, r));
+        }
+#elif defined(__SSE2__)
+        for (int i = 0; i < n; i += 8) {
+            auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(accumulator + i));
+            auto r = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(accumulator + i), _mm_sub_epi16(a, r));
+        }
+#else
+        for (int i = 0; i < n; i++)
+            accumulator[i] = static_cast<int16_t>(accumulator[i] - row[i]);
+#endif
+    }
+
+    /*
+     * Returns the dot product of the clipped accumulator with the given weights.
+     */
+    int32_t clippedDot(const int16_t *accumulator, const int16_t *weights, int n) {
+#if defined(__AVX2__)
+        auto zero = _mm256_setzero_si256();
+        auto clip = _mm256_set1_epi16(CLIP);
+        auto sum = _mm256_setzero_si256();
+        for (int i = 0; i < n; i += 16) {
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(accumulator + i));
+            auto w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i));
+            a = _mm256_min_epi16(_mm256_max_epi16(a, zero), clip);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, w));
+        }
+        auto sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0x4E));
+        sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0xB1));
+        return _mm_cvtsi128_si32(sum128);
+#elif defined(__SSE2__)
+        auto zero = _mm_setzero_si128();
+        auto clip = _mm_set1_epi16(CLIP);
+        auto sum = _mm_setzero_si128();
+        for (int i = 0; i < n; i += 8) {
+            auto a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(accumulator + i));
+            auto w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i));
+            a = _mm_min_epi16(_mm_max_epi16(a, zero), clip);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(a, w));
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        return _mm_cvtsi128_si32(sum);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < n; i++)
+            sum += std::clamp<int32_t>(accumulator[i], 0, CLIP) * weights[i];
+        return sum;
+#endif
+    }
+}
+
+/*
+ * Loads the network from the given file. On failure, the previously loaded network (if any) is kept.
+ */
+bool Nnue::load(const std::string &path) {
+    auto stream = std::ifstream(path, std::ios::binary);
+    if (!stream)
+        return false;
+
+    char magic[4];
+    uint32_t version, hidden;
+    if (!read(stream, magic, 4) || std::memcmp(magic, "PNUE", 4) != 0)
+        return false;
+
+    if (!read(stream, &version, 1) || version != 1)
+        return false;
+
+    if (!read(stream, &hidden, 1) || hidden == 0 || hidden % 16 != 0 || hidden > MAX_HIDDEN)
+        return false;
+
+    auto net = std::make_unique<Network>();
+    net->hidden = static_cast<int>(hidden);
+    net->featureBiases.resize(hidden);
+    net->featureWeights.resize(static_cast<std::size_t>(FEATURES) * hidden);
+    net->outputWeights.resize(2 * hidden);
+
+    std::vector<int8_t> outputWeights(2 * hidden);
+    if (!read(stream, net->featureBiases.data(), hidden) ||
+        !read(stream, net->featureWeights.data(), net->featureWeights.size()) ||
+        !read(stream, outputWeights.data(), outputWeights.size()) ||
+        !read(stream, &net->outputBias, 1))
+        return false;
+
+    std::copy(outputWeights.begin(), outputWeights.end(), net->outputWeights.begin());
+
+    network = std::move(net);
+    networkCount++;
+    return true;
+}
+
+/*
+ * Unloads the network, evaluation falls back to the handcrafted evaluation.
+ */
+void Nnue::unload() {
+    network.reset();
+}
+
+bool Nnue::isLoaded() {
+    return network != nullptr;
+}
+
+/*
+ * Returns a key that identifies the loaded network, to be mixed into the keys of cached scores.
+ */
+uint64_t Nnue::networkKey() {
+    return network ? networkCount * 0x9E3779B97F4A7C15UL : 0;
+}
+
+/*
+ * Returns the name of the vector instructions the network inference was compiled with.
+ */
+std::string Nnue::simdName() {
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+/*
+ * Resets the stack to contain only the root board. The root accumulators are computed on first evaluation.
+ */
+void Nnue::Accumulators::reset() {
+    if (network && hidden_ != network->hidden) {
+        hidden_ = network->hidden;
+        values_.assign(static_cast<std::size_t>(MAX_PLY) * 2 * hidden_, 0);
+    }
+
+    ply_ = 0;
+    entries_[0].dirtyPieces = Board::DirtyPieces();
+    entries_[0].kingMoved[0] = entries_[0].kingMoved[1] = true;
+    entries_[0].computed[0] = entries_[0].computed[1] = false;
+}
+
+/*
+ * Pushes the given board, which must be the result of making a move on the board on top of the stack.
+ */
+void Nnue::Accumulators::push(const Board &board) {
+    auto &entry = entries_[++ply_];
+    entry.dirtyPieces = board.dirtyPieces();
+    entry.computed[0] = entry.computed[1] = false;
+    entry.kingMoved[0] = entry.kingMoved[1] = entry.dirtyPieces.count < 0;
+
+    for (int i = 0; i < std::max(entry.dirtyPieces.count, 0); i++) {
+        auto bitboard = entry.dirtyPieces.changes[i].bitboard;
+        if (bitboard == 0)
+            entry.kingMoved[0] = true;
+        else if (bitboard == 6)
+            entry.kingMoved[1] = true;
+    }
+}
+
+void Nnue::Accumulators::pop() {
+    ply_--;
+}
+
+/*
+ * Returns the score of the given board, which must be the board on top of the stack, from the perspective of the side
+ * to move.
+ */
+int Nnue::Accumulators::evaluate(const Board &board) {
+    update(board, 0);
+    update(board, 1);
+
+    auto us = board.turn() == PieceColor::White ? 0 : 1;
+    auto &weights = network->outputWeights;
+
+    int32_t output = network->outputBias;
+    output += clippedDot(values(ply_, us), weights.data(), hidden_);
+    output += clippedDot(values(ply_, 1 - us), weights.data() + hidden_, hidden_);
+
+    return output / OUTPUT_SCALE;
+}
+
+/*
+ * Computes the accumulator on top of the stack for the given perspective.
+ */
+void Nnue::Accumulators::update(const Board &board, int perspective) {
+    // find the closest computed ancestor that can be updated incrementally
+    int ply = ply_;
+    while (!entries_[ply].computed[perspective]) {
+        if (entries_[ply].kingMoved[perspective] || ply == 0)
+            break;
+        ply--;
+    }
+
+    if (entries_[ply].computed[perspective]) {
+        auto king = kingSquare(board, perspective);
+
+        for (ply++; ply <= ply_; ply++) {
+            auto *accumulator = values(ply, perspective);
+            std::copy_n(values(ply - 1, perspective), hidden_, accumulator);
+
+            auto &dirtyPieces = entries_[ply].dirtyPieces;
+            for (int i = 0; i < dirtyPieces.count; i++) {
+                auto &change = dirtyPieces.changes[i];
+                auto feature = featureIndex(perspective, king, change.bitboard, change.square);
+                auto *row = network->featureWeights.data() + static_cast<std::size_t>(feature) * hidden_;
+
+                if (change.added)
+                    addRow(accumulator, row, hidden_);
+                else
+                    subRow(accumulator, row, hidden_);
+            }
+
+            entries_[ply].computed[perspective] = true;
+        }
+    } else {
+        // refresh from scratch
+        auto *accumulator = values(ply_, perspective);
+        std::copy_n(network->featureBiases.data(), hidden_, accumulator);
+
+        auto king = kingSquare(board, perspective);
+        auto &bitboards = board.getBitboards();
+        for (int bitboard = 0; bitboard < 12; bitboard++) {
+            for (auto bb = bitboards[bitboard]; bb; bb &= bb - 1) {
+                auto feature = featureIndex(perspective, king, bitboard, std::countr_zero(bb));
+                addRow(accumulator, network->featureWeights.data() + static_cast<std::size_t>(feature) * hidden_, hidden_);
+            }
+        }
+
+        entries_[ply_].computed[perspective] = true;
+    }
+}
+
+int16_t *Nnue::Accumulators::values(int ply, int perspective) {
+    return values_.data() + (static_cast<std::size_t>(ply) * 2 + perspective) * hidden_;
+}
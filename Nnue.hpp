@@ -0,0 +1,79 @@
+#ifndef CHESS_ENGINE_NNUE_HPP
+#define CHESS_ENGINE_NNUE_HPP
+
+#include "Board.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/*
+ * Efficiently updatable neural network evaluation.
+ *
+ * The network has a HalfKA feature set: for each perspective, every (own king square, piece, square) triple is one
+ * input feature. The features of both perspectives are transformed into two accumulators of `hidden` int16 values,
+ * which are updated incrementally when pieces are added or removed. The output layer takes the clipped accumulators,
+ * side to move first, and produces the score with int8 weights.
+ *
+ * Network file layout (little-endian):
+ *  - magic "PNUE" and uint32 version (1)
+ *  - uint32 hidden size, a multiple of 16
+ *  - int16 feature biases[hidden]
+ *  - int16 feature weights[FEATURES][hidden]
+ *  - int8 output weights[2 * hidden]
+ *  - int32 output bias
+ *
+ * Source: https://www.chessprogramming.org/NNUE
+ */
+namespace Nnue {
+    constexpr int FEATURES = 64 * 12 * 64;
+    constexpr int MAX_PLY = 256;
+
+    bool load(const std::string &path);
+
+    void unload();
+
+    [[nodiscard]] bool isLoaded();
+
+    [[nodiscard]] uint64_t networkKey();
+
+    [[nodiscard]] std::string simdName();
+
+    /*
+     * A stack of accumulators, one for each ply of the search path.
+     *
+     * Entries are only computed when a position on the path is evaluated. Computing an entry starts from the closest
+     * computed ancestor and applies the piece changes of the moves in between, unless the king of that perspective
+     * moved, in which case all features change and the accumulator is refreshed from the board.
+     */
+    class Accumulators {
+    public:
+
+        void reset();
+
+        void push(const Board &board);
+
+        void pop();
+
+        [[nodiscard]] int evaluate(const Board &board);
+
+    private:
+
+        struct Entry {
+            Board::DirtyPieces dirtyPieces;
+            bool kingMoved[2];
+            bool computed[2];
+        };
+
+        void update(const Board &board, int perspective);
+
+        int16_t *values(int ply, int perspective);
+
+        std::vector<Entry> entries_ = std::vector<Entry>(MAX_PLY);
+        std::vector<int16_t> values_;
+        int hidden_ = 0;
+        int ply_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,325 @@
+#include "Penguin.h"
+
+#include "EngineFactory.hpp"
+#include "Fen.hpp"
+#include "Nnue.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Reports the iterations of a search to the info callback of a handle, and records the depth of the best line.
+ */
+class InfoListener : public SearchListener {
+public:
+
+    void iterationCompleted(const SearchInfo &info) override;
+
+    void currentMove(int, const Move &, int) override {}
+
+    penguin_info_callback callback = nullptr;
+    void *userData = nullptr;
+    int depth = 0;
+};
+
+struct penguin_engine {
+    std::unique_ptr<Engine> engine;
+    Board board;
+    // hashes of the positions before the moves that were played to reach the board
+    std::vector<Board::U64> history;
+    InfoListener listener;
+    std::mutex mutex;
+    // signals of the searches that were requested and did not return yet, penguin_stop ends all of them without the
+    // mutex, which is held by the running search
+    std::vector<SearchSignals *> searches;
+    std::mutex searchesMutex;
+};
+
+static penguin_move toPenguinMove(const Move &move) {
+    penguin_move result{};
+    auto uci = move.toUci();
+    std::memcpy(result.uci, uci.data(), std::min(uci.size(), sizeof(result.uci) - 1));
+    return result;
+}
+
+/*
+ * Mate scores of the engine are in plies, the API gives them in moves like UCI does.
+ */
+static penguin_score toPenguinScore(const PrincipalVariation &pv) {
+    auto score = pv.score();
+
+    if (pv.isMate())
+        return {0, static_cast<int>(score < 0 ? std::floor(score / 2.0) : std::ceil(score / 2.0))};
+
+    return {static_cast<int>(score), 0};
+}
+
+void InfoListener::iterationCompleted(const SearchInfo &info) {
+    if (info.multiPv == 1)
+        depth = info.depth;
+
+    if (callback == nullptr)
+        return;
+
+    std::vector<penguin_move> moves;
+    for (auto move : info.pv)
+        moves.push_back(toPenguinMove(move));
+
+    penguin_info result{};
+    result.depth = info.depth;
+    result.seldepth = info.selDepth;
+    result.multipv = info.multiPv;
+    result.score = toPenguinScore(info.pv);
+    result.nodes = info.nodes;
+    result.time_ms = info.time.count();
+    result.hashfull = info.hashFull;
+    result.pv = moves.data();
+    result.pv_length = static_cast<int>(moves.size());
+
+    callback(&result, userData);
+}
+
+/*
+ * Plays the given legal move on the board, the hash of the position before the move is added to the history.
+ */
+static bool makeLegalMove(Board &board, std::vector<Board::U64> &history, std::string_view uci) {
+    auto move = Move::fromUci(uci);
+    if (!move.has_value())
+        return false;
+
+    Board::MoveVec moves;
+    board.legalMoves(moves);
+
+    if (std::find(moves.begin(), moves.end(), move.value()) == moves.end())
+        return false;
+
+    history.push_back(board.hash());
+    board.makeMove(move.value());
+    return true;
+}
+
+static uint64_t perft(const Board &board, int depth) {
+    Board::MoveVec moves;
+    board.legalMoves(moves);
+
+    if (depth == 1)
+        return moves.size();
+
+    uint64_t nodes = 0;
+
+    for (auto move : moves) {
+        auto newBoard = board;
+        newBoard.makeMove(move);
+        nodes += perft(newBoard, depth - 1);
+    }
+
+    return nodes;
+}
+
+static SearchLimits toSearchLimits(const penguin_limits &limits) {
+    SearchLimits result;
+
+    if (limits.depth > 0)
+        result.depth = limits.depth;
+    if (limits.nodes > 0)
+        result.nodes = limits.nodes;
+    if (limits.movetime_ms > 0)
+        result.moveTime = std::chrono::milliseconds(limits.movetime_ms);
+    if (limits.mate > 0)
+        result.mate = limits.mate;
+
+    if (limits.wtime_ms > 0 && limits.btime_ms > 0) {
+        TimeInfo timeInfo;
+        timeInfo.white = {std::chrono::milliseconds(limits.wtime_ms), std::chrono::milliseconds(limits.winc_ms)};
+        timeInfo.black = {std::chrono::milliseconds(limits.btime_ms), std::chrono::milliseconds(limits.binc_ms)};
+        if (limits.movestogo > 0)
+            timeInfo.movesToGo = limits.movestogo;
+        result.timeInfo = timeInfo;
+    }
+
+    result.infinite = limits.infinite != 0;
+    return result;
+}
+
+extern "C" {
+
+int penguin_api_version(void) {
+    return PENGUIN_API_VERSION;
+}
+
+penguin_engine *penguin_create(void) {
+    auto engine = EngineFactory::createEngine();
+    if (engine == nullptr)
+        return nullptr;
+
+    auto handle = new penguin_engine;
+    handle->engine = std::move(engine);
+    handle->board = Fen::createBoard(Fen::StartingPos).value();
+    handle->engine->setSearchListener(&handle->listener);
+    return handle;
+}
+
+void penguin_destroy(penguin_engine *engine) {
+    delete engine;
+}
+
+void penguin_new_game(penguin_engine *engine) {
+    std::lock_guard lock(engine->mutex);
+
+    engine->engine->newGame();
+    engine->board = Fen::createBoard(Fen::StartingPos).value();
+    engine->history.clear();
+}
+
+penguin_status penguin_set_position(penguin_engine *engine, const char *fen, const char *moves) {
+    auto board = Fen::createBoard(fen != nullptr ? fen : Fen::StartingPos);
+    if (!board.has_value())
+        return PENGUIN_INVALID_FEN;
+
+    std::vector<Board::U64> history;
+    auto remaining = std::string_view(moves != nullptr ? moves : "");
+
+    while (!remaining.empty()) {
+        auto end = std::min(remaining.find(' '), remaining.size());
+
+        if (end > 0 && !makeLegalMove(board.value(), history, remaining.substr(0, end)))
+            return PENGUIN_ILLEGAL_MOVE;
+
+        remaining.remove_prefix(std::min(end + 1, remaining.size()));
+    }
+
+    std::lock_guard lock(engine->mutex);
+
+    engine->board = board.value();
+    engine->history = std::move(history);
+    return PENGUIN_OK;
+}
+
+size_t penguin_get_fen(penguin_engine *engine, char *buffer, size_t size) {
+    std::string fen;
+
+    {
+        std::lock_guard lock(engine->mutex);
+        fen = Fen::toFen(engine->board);
+    }
+
+    if (buffer != nullptr && size > 0) {
+        auto length = std::min(fen.size(), size - 1);
+        std::memcpy(buffer, fen.data(), length);
+        buffer[length] = '\0';
+    }
+
+    return fen.size();
+}
+
+penguin_status penguin_set_multipv(penguin_engine *engine, int lines) {
+    std::lock_guard lock(engine->mutex);
+    return engine->engine->setMultiPv(lines) ? PENGUIN_OK : PENGUIN_INVALID_ARGUMENT;
+}
+
+void penguin_set_info_callback(penguin_engine *engine, penguin_info_callback callback, void *user_data) {
+    std::lock_guard lock(engine->mutex);
+
+    engine->listener.callback = callback;
+    engine->listener.userData = user_data;
+}
+
+penguin_status penguin_search(penguin_engine *engine, const penguin_limits *limits, penguin_result *result) {
+    if (result == nullptr)
+        return PENGUIN_INVALID_ARGUMENT;
+
+    // a stop that arrives while the search waits for the handle or is set up ends this search, a stop that arrived
+    // before this call does not
+    SearchSignals signals;
+
+    {
+        std::lock_guard lock(engine->searchesMutex);
+        engine->searches.push_back(&signals);
+    }
+
+    std::lock_guard lock(engine->mutex);
+
+    auto searchLimits = limits != nullptr ? toSearchLimits(*limits) : SearchLimits();
+    searchLimits.signals = &signals;
+
+    engine->engine->setGameHistory(engine->history);
+    engine->listener.depth = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto pv = engine->engine->pv(engine->board, searchLimits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    {
+        std::lock_guard searchesLock(engine->searchesMutex);
+        engine->searches.erase(std::find(engine->searches.begin(), engine->searches.end(), &signals));
+    }
+
+    *result = {};
+
+    auto move = pv.begin();
+    if (move != pv.end())
+        result->best_move = toPenguinMove(*move++);
+    if (move != pv.end())
+        result->ponder_move = toPenguinMove(*move);
+
+    auto statistics = engine->engine->statistics();
+
+    result->score = toPenguinScore(pv);
+    result->depth = engine->listener.depth;
+    result->nodes = statistics ? statistics->nodes : 0;
+    result->time_ms = elapsed.count();
+    return PENGUIN_OK;
+}
+
+void penguin_stop(penguin_engine *engine) {
+    std::lock_guard lock(engine->searchesMutex);
+
+    for (auto signals : engine->searches)
+        signals->stop = true;
+}
+
+int penguin_legal_moves(penguin_engine *engine, penguin_move *moves, int capacity) {
+    Board::MoveVec legalMoves;
+
+    {
+        std::lock_guard lock(engine->mutex);
+        engine->board.legalMoves(legalMoves);
+    }
+
+    for (int i = 0; i < capacity && i < static_cast<int>(legalMoves.size()); i++)
+        moves[i] = toPenguinMove(legalMoves[i]);
+
+    return static_cast<int>(legalMoves.size());
+}
+
+uint64_t penguin_perft(penguin_engine *engine, int depth) {
+    if (depth <= 0)
+        return 1;
+
+    Board board;
+
+    {
+        std::lock_guard lock(engine->mutex);
+        board = engine->board;
+    }
+
+    return perft(board, depth);
+}
+
+penguin_status penguin_load_network(const char *path) {
+    if (path == nullptr || *path == '\0') {
+        Nnue::unload();
+        return PENGUIN_OK;
+    }
+
+    return Nnue::load(path) ? PENGUIN_OK : PENGUIN_FILE_ERROR;
+}
+
+}
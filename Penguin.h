@@ -0,0 +1,161 @@
+#ifndef PENGUIN_H
+#define PENGUIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * C API of the engine, for embedding it in other programs without going through UCI.
+ *
+ * An engine handle owns a position and the search state of one game. Handles are independent, so different handles
+ * can be used from different threads at the same time. Calls on the same handle are serialized, except for
+ * penguin_stop, which can be called from any thread to end a running search on that handle.
+ *
+ * Moves are given and returned in UCI notation, e.g. "e2e4" or "e7e8q".
+ */
+
+#if defined(_WIN32) && !defined(PENGUIN_STATIC)
+#  ifdef PENGUIN_BUILD
+#    define PENGUIN_API __declspec(dllexport)
+#  else
+#    define PENGUIN_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define PENGUIN_API __attribute__((visibility("default")))
+#else
+#  define PENGUIN_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* version of this API, incremented on incompatible changes */
+#define PENGUIN_API_VERSION 1
+
+/* maximum number of legal moves in a chess position is 218 */
+#define PENGUIN_MAX_MOVES 256
+
+typedef struct penguin_engine penguin_engine;
+
+typedef enum penguin_status {
+    PENGUIN_OK = 0,
+    PENGUIN_INVALID_ARGUMENT,
+    PENGUIN_INVALID_FEN,
+    PENGUIN_ILLEGAL_MOVE,
+    PENGUIN_FILE_ERROR
+} penguin_status;
+
+/* a move in UCI notation, terminated by a null character */
+typedef struct penguin_move {
+    char uci[6];
+} penguin_move;
+
+/*
+ * Limits of a search, zero means no limit. The search stops at the first limit that is reached. The clock is only used
+ * when the time of both sides is given. A search without any limit searches up to a default depth.
+ */
+typedef struct penguin_limits {
+    int depth;
+    uint64_t nodes;
+    int64_t movetime_ms;
+    /* only search for a mate in at most this many moves */
+    int mate;
+    int64_t wtime_ms;
+    int64_t btime_ms;
+    int64_t winc_ms;
+    int64_t binc_ms;
+    int movestogo;
+    /* search until penguin_stop is called, the other limits are ignored */
+    int infinite;
+} penguin_limits;
+
+/*
+ * A score from the point of view of the side to move. If mate is non-zero, the side to move mates in that many moves
+ * or is mated when it is negative, and cp is not used.
+ */
+typedef struct penguin_score {
+    int cp;
+    int mate;
+} penguin_score;
+
+/* progress of a search, reported after every completed iteration of every line */
+typedef struct penguin_info {
+    int depth;
+    int seldepth;
+    int multipv;
+    penguin_score score;
+    uint64_t nodes;
+    int64_t time_ms;
+    /* permille of the evaluation cache that is in use */
+    int hashfull;
+    /* the moves of the line, only valid during the callback */
+    const penguin_move *pv;
+    int pv_length;
+} penguin_info;
+
+typedef void (*penguin_info_callback)(const penguin_info *info, void *user_data);
+
+typedef struct penguin_result {
+    /* empty if the side to move has no legal moves */
+    penguin_move best_move;
+    /* the expected reply, empty if unknown */
+    penguin_move ponder_move;
+    penguin_score score;
+    int depth;
+    uint64_t nodes;
+    int64_t time_ms;
+} penguin_result;
+
+PENGUIN_API int penguin_api_version(void);
+
+/* returns NULL if the engine could not be created */
+PENGUIN_API penguin_engine *penguin_create(void);
+
+PENGUIN_API void penguin_destroy(penguin_engine *engine);
+
+/* forgets the game history, the position is set to the starting position */
+PENGUIN_API void penguin_new_game(penguin_engine *engine);
+
+/*
+ * Sets the position to the given FEN, or the starting position if fen is NULL, followed by the given space separated
+ * moves, which may be NULL. The position is not changed if the FEN or one of the moves is invalid.
+ */
+PENGUIN_API penguin_status penguin_set_position(penguin_engine *engine, const char *fen, const char *moves);
+
+/* writes the FEN of the current position to buffer, returns the length of the FEN like snprintf */
+PENGUIN_API size_t penguin_get_fen(penguin_engine *engine, char *buffer, size_t size);
+
+PENGUIN_API penguin_status penguin_set_multipv(penguin_engine *engine, int lines);
+
+/* the callback is called on the thread that runs the search, NULL disables it */
+PENGUIN_API void penguin_set_info_callback(penguin_engine *engine, penguin_info_callback callback, void *user_data);
+
+/* searches the current position, blocks until the search ends; limits may be NULL */
+PENGUIN_API penguin_status penguin_search(penguin_engine *engine, const penguin_limits *limits,
+                                          penguin_result *result);
+
+/*
+ * Ends the searches of the engine as soon as possible, they still return their best move. This includes a search whose
+ * penguin_search call has not started searching yet, so a stop that races with the start of a search is not lost. A
+ * stop while no penguin_search call is in progress has no effect, it does not end a later search.
+ */
+PENGUIN_API void penguin_stop(penguin_engine *engine);
+
+/* writes at most capacity legal moves of the current position, returns the number of legal moves */
+PENGUIN_API int penguin_legal_moves(penguin_engine *engine, penguin_move *moves, int capacity);
+
+/* counts the leaf nodes of the legal move tree of the current position up to the given depth */
+PENGUIN_API uint64_t penguin_perft(penguin_engine *engine, int depth);
+
+/*
+ * Loads the evaluation network that is used by all engines, NULL or an empty path unloads it. The network is shared,
+ * so this must not be called while any engine is searching.
+ */
+PENGUIN_API penguin_status penguin_load_network(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
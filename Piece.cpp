@@ -2,21 +2,6 @@
 
 #include <ostream>
 
-const Piece Piece::WhitePawn = Piece(PieceColor::White, PieceType::Pawn);
-const Piece Piece::WhiteKnight = Piece(PieceColor::White, PieceType::Knight);
-const Piece Piece::WhiteBishop = Piece(PieceColor::White, PieceType::Bishop);
-const Piece Piece::WhiteRook = Piece(PieceColor::White, PieceType::Rook);
-const Piece Piece::WhiteQueen = Piece(PieceColor::White, PieceType::Queen);
-const Piece Piece::WhiteKing = Piece(PieceColor::White, PieceType::King);
-const Piece Piece::BlackPawn = Piece(PieceColor::Black, PieceType::Pawn);
-const Piece Piece::BlackKnight = Piece(PieceColor::Black, PieceType::Knight);
-const Piece Piece::BlackBishop = Piece(PieceColor::Black, PieceType::Bishop);
-const Piece Piece::BlackRook = Piece(PieceColor::Black, PieceType::Rook);
-const Piece Piece::BlackQueen = Piece(PieceColor::Black, PieceType::Queen);
-const Piece Piece::BlackKing = Piece(PieceColor::Black, PieceType::King);
-
-Piece::Piece(PieceColor color, PieceType type) : color_(color), type_(type) {}
-
 /*
  * Constructs a Piece from a symbol.
  */
@@ -57,7 +42,7 @@ Piece::Optional Piece::fromSymbol(char symbol) {
 char Piece::toSymbol() const {
     char symbol;
 
-    switch (type_) {
+    switch (type()) {
         case PieceType::Pawn:
             symbol = 'p';
             break;
@@ -80,27 +65,19 @@ char Piece::toSymbol() const {
             symbol = '?';
     }
 
-    if (color_ == PieceColor::White) {
+    if (color() == PieceColor::White) {
         symbol = toupper(symbol, std::locale());
     }
 
     return symbol;
 }
 
-PieceColor Piece::color() const {
-    return color_;
-}
-
-PieceType Piece::type() const {
-    return type_;
-}
-
 /*
  * Returns the value of the piece in centipawns.
  * Based on https://www.chessprogramming.org/Point_Value.
  */
 int Piece::value() const {
-    switch (type_) {
+    switch (type()) {
         case PieceType::Pawn:
             return 100;
         case PieceType::Knight:
@@ -118,29 +95,10 @@ int Piece::value() const {
     }
 }
 
-bool operator==(const Piece &lhs, const Piece &rhs) {
-    return lhs.color() == rhs.color() && lhs.type() == rhs.type();
-}
-
-bool operator<(const Piece &lhs, const Piece &rhs) {
-    return lhs.color() < rhs.color() || (lhs.color() == rhs.color() && lhs.type() < rhs.type());
-}
-
 std::ostream &operator<<(std::ostream &os, const Piece &piece) {
     return os << piece.toSymbol();
 }
 
-/*
- * Returns the opposite color of the given color.
- */
-PieceColor operator!(PieceColor color) {
-    if (color == PieceColor::White) {
-        return PieceColor::Black;
-    } else {
-        return PieceColor::White;
-    }
-}
-
 std::ostream &operator<<(std::ostream &os, const PieceType type) {
     std::string s = "Unknown";
 
@@ -3,6 +3,7 @@
 
 #include <optional>
 #include <iosfwd>
+#include <cstdint>
 
 enum class PieceColor {
     White,
@@ -23,15 +24,32 @@ public:
 
     using Optional = std::optional<Piece>;
 
-    Piece(PieceColor color, PieceType type);
+    constexpr Piece(PieceColor color, PieceType type)
+            : bitboard_(static_cast<uint8_t>((color == PieceColor::White ? 0 : 6) + 5 - static_cast<int>(type))) {}
+
+    static constexpr Piece fromBitboardIndex(int index) {
+        return Piece(static_cast<uint8_t>(index));
+    }
 
     static Optional fromSymbol(char symbol);
 
     [[nodiscard]] char toSymbol() const;
 
-    [[nodiscard]] PieceColor color() const;
+    [[nodiscard]] constexpr PieceColor color() const {
+        return bitboard_ < 6 ? PieceColor::White : PieceColor::Black;
+    }
+
+    [[nodiscard]] constexpr PieceType type() const {
+        return static_cast<PieceType>(5 - bitboard_ % 6);
+    }
 
-    [[nodiscard]] PieceType type() const;
+    /*
+     * Returns the index of the bitboard that stores this piece on a Board. Bitboards are ordered by color, then from
+     * king to pawn, which is the reverse of the order of the piece types.
+     */
+    [[nodiscard]] constexpr int bitboardIndex() const {
+        return bitboard_;
+    }
 
     [[nodiscard]] int value() const;
 
@@ -39,18 +57,39 @@ public:
     static const Piece BlackPawn, BlackKnight, BlackBishop, BlackRook, BlackQueen, BlackKing;
 
 private:
-    PieceColor color_;
-    PieceType type_;
-};
 
-bool operator==(const Piece &lhs, const Piece &rhs);
+    constexpr explicit Piece(uint8_t bitboard) : bitboard_(bitboard) {}
+
+    uint8_t bitboard_;
+};
 
-bool operator<(const Piece &lhs, const Piece &rhs);
+inline constexpr Piece Piece::WhitePawn = Piece(PieceColor::White, PieceType::Pawn);
+inline constexpr Piece Piece::WhiteKnight = Piece(PieceColor::White, PieceType::Knight);
+inline constexpr Piece Piece::WhiteBishop = Piece(PieceColor::White, PieceType::Bishop);
+inline constexpr Piece Piece::WhiteRook = Piece(PieceColor::White, PieceType::Rook);
+inline constexpr Piece Piece::WhiteQueen = Piece(PieceColor::White, PieceType::Queen);
+inline constexpr Piece Piece::WhiteKing = Piece(PieceColor::White, PieceType::King);
+inline constexpr Piece Piece::BlackPawn = Piece(PieceColor::Black, PieceType::Pawn);
+inline constexpr Piece Piece::BlackKnight = Piece(PieceColor::Black, PieceType::Knight);
+inline constexpr Piece Piece::BlackBishop = Piece(PieceColor::Black, PieceType::Bishop);
+inline constexpr Piece Piece::BlackRook = Piece(PieceColor::Black, PieceType::Rook);
+inline constexpr Piece Piece::BlackQueen = Piece(PieceColor::Black, PieceType::Queen);
+inline constexpr Piece Piece::BlackKing = Piece(PieceColor::Black, PieceType::King);
+
+constexpr bool operator==(const Piece &lhs, const Piece &rhs) {
+    return lhs.bitboardIndex() == rhs.bitboardIndex();
+}
+
+constexpr bool operator<(const Piece &lhs, const Piece &rhs) {
+    return lhs.color() < rhs.color() || (lhs.color() == rhs.color() && lhs.type() < rhs.type());
+}
 
 std::ostream &operator<<(std::ostream &os, const Piece &piece);
 
 // Invert a color (White becomes Black and vice versa)
-PieceColor operator!(PieceColor color);
+constexpr PieceColor operator!(PieceColor color) {
+    return color == PieceColor::White ? PieceColor::Black : PieceColor::White;
+}
 
 std::ostream &operator<<(std::ostream &os, PieceType type);
 
@@ -0,0 +1,30 @@
+#ifndef CHESS_ENGINE_SCORE_HPP
+#define CHESS_ENGINE_SCORE_HPP
+
+#include <cstdint>
+
+/*
+ * A score that holds both a middlegame and an endgame value, packed into a single integer.
+ *
+ * The endgame value is stored in the upper 16 bits and the middlegame value in the lower 16 bits. Since the halves are
+ * stored as a sum, two scores can be added or subtracted with a single integer operation, as long as both halves stay
+ * within the range of a 16-bit integer.
+ *
+ * Source: https://www.chessprogramming.org/Tapered_Eval
+ */
+using Score = int32_t;
+
+constexpr Score makeScore(int mg, int eg) {
+    return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+}
+
+constexpr int mgValue(Score score) {
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+}
+
+constexpr int egValue(Score score) {
+    // rounds the upper half up when the lower half is negative, which borrowed one from the upper half
+    return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score + 0x8000) >> 16));
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef CHESS_ENGINE_SEARCHLIMITS_HPP
+#define CHESS_ENGINE_SEARCHLIMITS_HPP
+
+#include "TimeInfo.hpp"
+
+#include <optional>
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+
+/*
+ * Signals that are sent to a running search by another thread. The owner resets them before starting a search.
+ */
+struct SearchSignals {
+    std::atomic<bool> stop = false;
+    // the opponent played the move the search was pondering on, the search continues with its normal limits
+    std::atomic<bool> ponderHit = false;
+
+    void reset() {
+        stop = false;
+        ponderHit = false;
+    }
+};
+
+/*
+ * Limits of a search, the search stops as soon as one of the given limits is reached or when it is stopped through its
+ * signals. A search without any limit searches up to a default depth.
+ */
+struct SearchLimits {
+    TimeInfo::Optional timeInfo;
+    std::optional<int> depth;
+    std::optional<uint64_t> nodes;
+    std::optional<std::chrono::milliseconds> moveTime;
+    // only search for a mate in at most this many moves
+    std::optional<int> mate;
+    // search until stopped, the other limits are ignored
+    bool infinite = false;
+    // search without limits until a ponder hit, the limits are applied from that moment on
+    bool ponder = false;
+    // signals of the caller, if any
+    SearchSignals *signals = nullptr;
+};
+
+#endif
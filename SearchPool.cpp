@@ -0,0 +1,111 @@
+#include "SearchPool.hpp"
+
+#include <algorithm>
+
+SearchPool::SearchPool(int threads) {
+    for (int i = 0; i < std::max(threads, 1); i++)
+        threads_.emplace_back(&SearchPool::work, this);
+}
+
+/*
+ * Runs the searches that are still waiting and stops the threads.
+ */
+SearchPool::~SearchPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopped_ = true;
+    }
+
+    condition_.notify_all();
+
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+/*
+ * Queues a search, the remaining time is the clock time of the side to move, or nullopt for searches without a clock.
+ */
+void SearchPool::submit(std::optional<std::chrono::milliseconds> remainingTime, Job job) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push({false, remainingTime, nextSequence_++, std::move(job), nullptr});
+        waitingJobs_++;
+
+        if (waitingJobs_ > idleThreads_)
+            interruptBackground();
+    }
+
+    condition_.notify_one();
+}
+
+/*
+ * Queues a background search. The interrupt is called at most once while the job runs, and must make the job return
+ * soon.
+ */
+void SearchPool::submitBackground(Job job, Job interrupt) {
+    {
+        std::lock_guard lock(mutex_);
+        queue_.push({true, std::nullopt, nextSequence_++, std::move(job), std::move(interrupt)});
+    }
+
+    condition_.notify_one();
+}
+
+std::size_t SearchPool::threadCount() const {
+    return threads_.size();
+}
+
+bool SearchPool::RunsLater::operator()(const Entry &lhs, const Entry &rhs) const {
+    if (lhs.background != rhs.background)
+        return lhs.background;
+
+    if (lhs.remainingTime != rhs.remainingTime) {
+        if (!lhs.remainingTime.has_value() || !rhs.remainingTime.has_value())
+            return !lhs.remainingTime.has_value();
+
+        return *lhs.remainingTime > *rhs.remainingTime;
+    }
+
+    return lhs.sequence > rhs.sequence;
+}
+
+/*
+ * Interrupts the oldest running background job, the caller holds the mutex.
+ */
+void SearchPool::interruptBackground() {
+    if (runningBackground_.empty())
+        return;
+
+    auto oldest = runningBackground_.begin();
+    oldest->second();
+    runningBackground_.erase(oldest);
+}
+
+void SearchPool::work() {
+    std::unique_lock lock(mutex_);
+
+    while (true) {
+        idleThreads_++;
+        condition_.wait(lock, [this] { return !queue_.empty() || stopped_; });
+        idleThreads_--;
+
+        if (queue_.empty())
+            return;
+
+        // the entry is moved out of the queue, top() is const because changing it could break the heap order
+        auto entry = std::move(const_cast<Entry &>(queue_.top()));
+        queue_.pop();
+
+        if (entry.background) {
+            runningBackground_[entry.sequence] = std::move(entry.interrupt);
+        } else {
+            waitingJobs_--;
+        }
+
+        lock.unlock();
+        entry.job();
+        lock.lock();
+
+        runningBackground_.erase(entry.sequence);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef CHESS_ENGINE_SEARCHPOOL_HPP
+#define CHESS_ENGINE_SEARCHPOOL_HPP
+
+#include <functional>
+#include <optional>
+#include <vector>
+#include <map>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * A fixed set of threads that runs the searches of many UCI sessions.
+ *
+ * Waiting searches are started in order of the remaining clock time of the side to move, least time first, so a game
+ * that is short on time is not held up by games that have plenty. Searches without a clock come after those on a clock,
+ * in the order in which they were submitted.
+ *
+ * Background searches, i.e. pondering and infinite searches, only get a thread when no other search is waiting. They
+ * don't end on their own, so when a search is submitted while all threads are busy, a running background search is
+ * interrupted to free its thread. Other searches are never interrupted.
+ *
+ * The evaluation caches are thread local, so the sessions share the caches of the pool threads and their memory is
+ * bounded by the number of threads instead of the number of sessions.
+ */
+class SearchPool {
+public:
+
+    using Job = std::function<void()>;
+
+    explicit SearchPool(int threads);
+
+    ~SearchPool();
+
+    SearchPool(const SearchPool &) = delete;
+
+    SearchPool &operator=(const SearchPool &) = delete;
+
+    void submit(std::optional<std::chrono::milliseconds> remainingTime, Job job);
+
+    void submitBackground(Job job, Job interrupt);
+
+    [[nodiscard]] std::size_t threadCount() const;
+
+private:
+
+    struct Entry {
+        bool background;
+        std::optional<std::chrono::milliseconds> remainingTime;
+        uint64_t sequence;
+        Job job;
+        Job interrupt;
+    };
+
+    // orders the queue so that its top is the entry that runs first
+    struct RunsLater {
+        bool operator()(const Entry &lhs, const Entry &rhs) const;
+    };
+
+    void work();
+
+    void interruptBackground();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::priority_queue<Entry, std::vector<Entry>, RunsLater> queue_;
+    uint64_t nextSequence_ = 0;
+    // threads that wait for a job, and queued jobs that are not in the background
+    std::size_t idleThreads_ = 0;
+    std::size_t waitingJobs_ = 0;
+    // interrupts of the running background jobs that were not interrupted yet, by sequence
+    std::map<uint64_t, Job> runningBackground_;
+    bool stopped_ = false;
+};
+
+#endif
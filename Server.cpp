@@ -0,0 +1,246 @@
+#include "Server.hpp"
+
+#include "Uci.hpp"
+#include "EngineFactory.hpp"
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#define SERVER_BACKLOG 64
+#define SOCKET_BUFFER_SIZE 4096
+
+/*
+ * Stream buffer that reads from and writes to a connected socket. Reading and writing may happen on different threads,
+ * as the UCI session reads commands while its search sends info.
+ */
+class SocketBuffer : public std::streambuf {
+public:
+
+    explicit SocketBuffer(int socket) : socket_(socket) {
+        setg(input_, input_, input_);
+        setp(output_, output_ + SOCKET_BUFFER_SIZE);
+    }
+
+protected:
+
+    int_type underflow() override {
+        ssize_t received;
+
+        do {
+            received = recv(socket_, input_, SOCKET_BUFFER_SIZE, 0);
+        } while (received < 0 && errno == EINTR);
+
+        if (received <= 0)
+            return traits_type::eof();
+
+        setg(input_, input_, input_ + received);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    int_type overflow(int_type c) override {
+        if (sync() != 0)
+            return traits_type::eof();
+
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    int sync() override {
+        for (auto data = pbase(); data < pptr();) {
+            // a client that disconnected must not kill the server with SIGPIPE
+            auto sent = send(socket_, data, pptr() - data, MSG_NOSIGNAL);
+
+            if (sent < 0 && errno == EINTR)
+                continue;
+
+            if (sent <= 0) {
+                setp(output_, output_ + SOCKET_BUFFER_SIZE);
+                return -1;
+            }
+
+            data += sent;
+        }
+
+        setp(output_, output_ + SOCKET_BUFFER_SIZE);
+        return 0;
+    }
+
+private:
+
+    int socket_;
+    char input_[SOCKET_BUFFER_SIZE];
+    char output_[SOCKET_BUFFER_SIZE];
+};
+
+Server::Server(int threads) : pool_(threads) {}
+
+Server::~Server() {
+    stop();
+
+    if (listenSocket_ >= 0)
+        close(listenSocket_);
+
+    if (!socketPath_.empty())
+        unlink(socketPath_.c_str());
+}
+
+/*
+ * Listens on a Unix domain socket at the given path, a file that already exists at the path is replaced.
+ */
+bool Server::listenUnix(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path))
+        return false;
+
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    listenSocket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket_ < 0)
+        return false;
+
+    unlink(path.c_str());
+
+    if (bind(listenSocket_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket_, SERVER_BACKLOG) != 0) {
+        close(listenSocket_);
+        listenSocket_ = -1;
+        return false;
+    }
+
+    socketPath_ = path;
+    return true;
+}
+
+/*
+ * Listens on the given TCP port of the loopback interface, so only local clients can connect. Port 0 picks a free port,
+ * which is returned by port().
+ */
+bool Server::listenTcp(uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    listenSocket_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenSocket_ < 0)
+        return false;
+
+    int reuse = 1;
+    setsockopt(listenSocket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    socklen_t length = sizeof(address);
+
+    if (bind(listenSocket_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket_, SERVER_BACKLOG) != 0 ||
+        getsockname(listenSocket_, reinterpret_cast<sockaddr *>(&address), &length) != 0) {
+        close(listenSocket_);
+        listenSocket_ = -1;
+        return false;
+    }
+
+    port_ = ntohs(address.sin_port);
+    return true;
+}
+
+uint16_t Server::port() const {
+    return port_;
+}
+
+/*
+ * Accepts sessions until the server is stopped, then ends the sessions that are still connected.
+ */
+void Server::run() {
+    while (!stopped_) {
+        int socket = accept(listenSocket_, nullptr, nullptr);
+
+        if (socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            break;
+        }
+
+        std::lock_guard lock(mutex_);
+        joinFinishedSessions();
+
+        auto id = nextSession_++;
+        sessions_[id] = {std::thread(&Server::runSession, this, socket, id), socket};
+    }
+
+    std::map<std::size_t, Session> sessions;
+
+    {
+        std::lock_guard lock(mutex_);
+
+        // the sessions read end of file and quit
+        for (auto &[id, session] : sessions_) {
+            if (session.socket >= 0)
+                shutdown(session.socket, SHUT_RDWR);
+        }
+
+        sessions.swap(sessions_);
+        finishedSessions_.clear();
+    }
+
+    for (auto &[id, session] : sessions)
+        session.thread.join();
+}
+
+/*
+ * Stops accepting sessions, can be called from any thread.
+ */
+void Server::stop() {
+    stopped_ = true;
+
+    // wakes up accept
+    if (listenSocket_ >= 0)
+        shutdown(listenSocket_, SHUT_RDWR);
+}
+
+void Server::runSession(int socket, std::size_t id) {
+    {
+        SocketBuffer buffer(socket);
+        std::istream cmdIn(&buffer);
+        std::ostream cmdOut(&buffer);
+
+        if (auto engine = EngineFactory::createEngine(); engine != nullptr) {
+            auto uci = Uci(std::move(engine), cmdIn, cmdOut, pool_);
+            uci.run();
+        }
+    }
+
+    std::lock_guard lock(mutex_);
+    close(socket);
+
+    if (auto session = sessions_.find(id); session != sessions_.end()) {
+        session->second.socket = -1;
+        finishedSessions_.push_back(id);
+    }
+}
+
+/*
+ * Joins the threads of the sessions that ended, the caller holds the mutex.
+ */
+void Server::joinFinishedSessions() {
+    for (auto id : finishedSessions_) {
+        sessions_[id].thread.join();
+        sessions_.erase(id);
+    }
+
+    finishedSessions_.clear();
+}
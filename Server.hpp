@@ -0,0 +1,67 @@
+#ifndef CHESS_ENGINE_SERVER_HPP
+#define CHESS_ENGINE_SERVER_HPP
+
+#include "SearchPool.hpp"
+
+#include <string>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Serves UCI sessions over a Unix domain socket or a TCP port on the loopback interface.
+ *
+ * Every connection is an independent UCI session with its own engine, board and game history, handled on its own
+ * thread. The searches of all sessions run on one shared SearchPool, so many games can be played by a single process
+ * without a thread per game searching at the same time. The evaluation network is loaded once and shared read-only.
+ */
+class Server {
+public:
+
+    explicit Server(int threads);
+
+    ~Server();
+
+    Server(const Server &) = delete;
+
+    Server &operator=(const Server &) = delete;
+
+    bool listenUnix(const std::string &path);
+
+    bool listenTcp(uint16_t port);
+
+    [[nodiscard]] uint16_t port() const;
+
+    void run();
+
+    void stop();
+
+private:
+
+    struct Session {
+        std::thread thread;
+        // -1 once the session ended and closed its socket
+        int socket;
+    };
+
+    void runSession(int socket, std::size_t id);
+
+    void joinFinishedSessions();
+
+    SearchPool pool_;
+    int listenSocket_ = -1;
+    std::string socketPath_;
+    uint16_t port_ = 0;
+    std::atomic<bool> stopped_ = false;
+
+    std::mutex mutex_;
+    std::map<std::size_t, Session> sessions_;
+    std::vector<std::size_t> finishedSessions_;
+    std::size_t nextSession_ = 0;
+};
+
+#endif
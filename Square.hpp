@@ -4,6 +4,8 @@
 #include <optional>
 #include <iosfwd>
 #include <string>
+#include <string_view>
+#include <cstdint>
 
 class Square {
 public:
@@ -12,17 +14,29 @@ public:
     using Index = unsigned;
     using Optional = std::optional<Square>;
 
+    /*
+     * Constructs a Square from an index that is known to be valid, i.e., smaller than 64.
+     * Use `fromIndex` when the index comes from user input.
+     */
+    constexpr explicit Square(Index index) : index_(static_cast<uint8_t>(index)) {}
+
     static Optional fromCoordinates(Coordinate file, Coordinate rank);
 
     static Optional fromIndex(Index index);
 
-    static Optional fromName(const std::string &name);
+    static Optional fromName(std::string_view name);
 
-    [[nodiscard]] Coordinate file() const;
+    [[nodiscard]] constexpr Coordinate file() const {
+        return index_ % 8;
+    }
 
-    [[nodiscard]] Coordinate rank() const;
+    [[nodiscard]] constexpr Coordinate rank() const {
+        return index_ / 8;
+    }
 
-    [[nodiscard]] Index index() const;
+    [[nodiscard]] constexpr Index index() const {
+        return index_;
+    }
 
     [[nodiscard]] std::string toName() const;
 
@@ -37,16 +51,91 @@ public:
 
 private:
 
-    explicit Square(Index index);
-
-    Coordinate file_, rank_;
+    // index of the square, a1 is 0 and h8 is 63
+    uint8_t index_;
 };
 
 std::ostream &operator<<(std::ostream &os, const Square &square);
 
 // Necessary to support Square as the key in std::map.
-bool operator<(const Square &lhs, const Square &rhs);
-
-bool operator==(const Square &lhs, const Square &rhs);
+constexpr bool operator<(const Square &lhs, const Square &rhs) {
+    return lhs.index() < rhs.index();
+}
+
+constexpr bool operator==(const Square &lhs, const Square &rhs) {
+    return lhs.index() == rhs.index();
+}
+
+inline constexpr Square Square::A1 = Square(0 + 0);
+inline constexpr Square Square::B1 = Square(0 + 1);
+inline constexpr Square Square::C1 = Square(0 + 2);
+inline constexpr Square Square::D1 = Square(0 + 3);
+inline constexpr Square Square::E1 = Square(0 + 4);
+inline constexpr Square Square::F1 = Square(0 + 5);
+inline constexpr Square Square::G1 = Square(0 + 6);
+inline constexpr Square Square::H1 = Square(0 + 7);
+
+inline constexpr Square Square::A2 = Square(8 + 0);
+inline constexpr Square Square::B2 = Square(8 + 1);
+inline constexpr Square Square::C2 = Square(8 + 2);
+inline constexpr Square Square::D2 = Square(8 + 3);
+inline constexpr Square Square::E2 = Square(8 + 4);
+inline constexpr Square Square::F2 = Square(8 + 5);
+inline constexpr Square Square::G2 = Square(8 + 6);
+inline constexpr Square Square::H2 = Square(8 + 7);
+
+inline constexpr Square Square::A3 = Square(16 + 0);
+inline constexpr Square Square::B3 = Square(16 + 1);
+inline constexpr Square Square::C3 = Square(16 + 2);
+inline constexpr Square Square::D3 = Square(16 + 3);
+inline constexpr Square Square::E3 = Square(16 + 4);
+inline constexpr Square Square::F3 = Square(16 + 5);
+inline constexpr Square Square::G3 = Square(16 + 6);
+inline constexpr Square Square::H3 = Square(16 + 7);
+
+inline constexpr Square Square::A4 = Square(24 + 0);
+inline constexpr Square Square::B4 = Square(24 + 1);
+inline constexpr Square Square::C4 = Square(24 + 2);
+inline constexpr Square Square::D4 = Square(24 + 3);
+inline constexpr Square Square::E4 = Square(24 + 4);
+inline constexpr Square Square::F4 = Square(24 + 5);
+inline constexpr Square Square::G4 = Square(24 + 6);
+inline constexpr Square Square::H4 = Square(24 + 7);
+
+inline constexpr Square Square::A5 = Square(32 + 0);
+inline constexpr Square Square::B5 = Square(32 + 1);
+inline constexpr Square Square::C5 = Square(32 + 2);
+inline constexpr Square Square::D5 = Square(32 + 3);
+inline constexpr Square Square::E5 = Square(32 + 4);
+inline constexpr Square Square::F5 = Square(32 + 5);
+inline constexpr Square Square::G5 = Square(32 + 6);
+inline constexpr Square Square::H5 = Square(32 + 7);
+
+inline constexpr Square Square::A6 = Square(40 + 0);
+inline constexpr Square Square::B6 = Square(40 + 1);
+inline constexpr Square Square::C6 = Square(40 + 2);
+inline constexpr Square Square::D6 = Square(40 + 3);
+inline constexpr Square Square::E6 = Square(40 + 4);
+inline constexpr Square Square::F6 = Square(40 + 5);
+inline constexpr Square Square::G6 = Square(40 + 6);
+inline constexpr Square Square::H6 = Square(40 + 7);
+
+inline constexpr Square Square::A7 = Square(48 + 0);
+inline constexpr Square Square::B7 = Square(48 + 1);
+inline constexpr Square Square::C7 = Square(48 + 2);
+inline constexpr Square Square::D7 = Square(48 + 3);
+inline constexpr Square Square::E7 = Square(48 + 4);
+inline constexpr Square Square::F7 = Square(48 + 5);
+inline constexpr Square Square::G7 = Square(48 + 6);
+inline constexpr Square Square::H7 = Square(48 + 7);
+
+inline constexpr Square Square::A8 = Square(56 + 0);
+inline constexpr Square Square::B8 = Square(56 + 1);
+inline constexpr Square Square::C8 = Square(56 + 2);
+inline constexpr Square Square::D8 = Square(56 + 3);
+inline constexpr Square Square::E8 = Square(56 + 4);
+inline constexpr Square Square::F8 = Square(56 + 5);
+inline constexpr Square Square::G8 = Square(56 + 6);
+inline constexpr Square Square::H8 = Square(56 + 7);
 
 #endif
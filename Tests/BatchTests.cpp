@@ -0,0 +1,113 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "Batch.hpp"
+#include "Fen.hpp"
+
+#include <set>
+#include <vector>
+#include <mutex>
+
+TEST_CASE("Puzzle CSV lines are played up to the first move of the solution", "[Batch]") {
+    auto line = "uj7Uv,6k1/r4p2/6p1/4B3/p4P2/5r1p/K1R5/8 b - - 5 43,a7b7 c2c8 g8h7 c8h8,840,100,67,43,"
+                "endgame mate mateIn2 short,https://lichess.org/Z3FRw1Fn/black#86";
+
+    auto position = Batch::parseLine(line, Batch::Format::Csv, 3);
+    REQUIRE(position.has_value());
+
+    REQUIRE(position->index == 3);
+    REQUIRE(position->id == "uj7Uv");
+    REQUIRE(Fen::toFen(position->board) == "6k1/1r3p2/6p1/4B3/p4P2/5r1p/K1R5/8 w - - 6 44");
+
+    REQUIRE_FALSE(Batch::parseLine("PuzzleId,FEN,Moves,Rating,RatingDeviation,Popularity,NbPlays,Themes,GameUrl",
+                                   Batch::Format::Csv, 0).has_value());
+    REQUIRE_FALSE(Batch::parseLine("", Batch::Format::Csv, 0).has_value());
+    REQUIRE_FALSE(Batch::parseLine("x,not a fen,a7b7", Batch::Format::Csv, 0).has_value());
+    REQUIRE_FALSE(Batch::parseLine("x1,6k1/8/8/8/8/8/8/R5K1 w - - 0 1,e2e4 a1a8", Batch::Format::Csv, 0).has_value());
+    REQUIRE_FALSE(Batch::parseLine("x2,6k1/8/8/8/8/8/8/R5K1 w - - 0 1,a1b2 a1a8", Batch::Format::Csv, 0).has_value());
+}
+
+TEST_CASE("EPD lines take their id from the id operation", "[Batch]") {
+    auto line = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 bm e5; id \"open\";";
+
+    auto position = Batch::parseLine(line, Batch::Format::Epd, 0);
+    REQUIRE(position.has_value());
+
+    REQUIRE(position->id == "open");
+    REQUIRE(Fen::toFen(position->board) == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+
+    REQUIRE_FALSE(Batch::parseLine("# comment", Batch::Format::Epd, 0).has_value());
+    REQUIRE(Batch::formatOf("puzzles.csv") == Batch::Format::Csv);
+    REQUIRE(Batch::formatOf("tests.epd") == Batch::Format::Epd);
+}
+
+TEST_CASE("Results are written as JSON", "[Batch]") {
+    auto result = Batch::Result{
+        .index = 4,
+        .id = "a\"b",
+        .fen = "8/8/8/8/8/8/8/K6k w - - 0 1",
+        .bestMove = Move::fromUci("a1a2"),
+        .score = -35,
+        .mate = false,
+        .depth = 6,
+        .nodes = 1234,
+        .time = std::chrono::milliseconds(56)
+    };
+
+    REQUIRE(Batch::toJson(result) == R"({"index":4,"id":"a\"b","fen":"8/8/8/8/8/8/8/K6k w - - 0 1",)"
+                                     R"("bestmove":"a1a2","score":{"cp":-35},"depth":6,"nodes":1234,"time":56})");
+
+    result.bestMove = std::nullopt;
+    result.score = -1;
+    result.mate = true;
+
+    REQUIRE(Batch::toJson(result) == R"({"index":4,"id":"a\"b","fen":"8/8/8/8/8/8/8/K6k w - - 0 1",)"
+                                     R"("bestmove":null,"score":{"mate":-1},"depth":6,"nodes":1234,"time":56})");
+}
+
+TEST_CASE("The analyser reports a result for every position", "[Batch]") {
+    auto limits = SearchLimits();
+    limits.depth = 2;
+
+    // the callback runs on the threads of the analyser, so the results are only checked afterwards
+    std::mutex mutex;
+    std::vector<Batch::Result> results;
+
+    auto analyser = Batch::Analyser(2, limits, [&](const Batch::Result &result) {
+        auto lock = std::lock_guard(mutex);
+        results.push_back(result);
+    });
+
+    auto fens = {
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"
+    };
+
+    std::size_t index = 0;
+
+    for (auto fen : fens) {
+        auto line = std::string(fen) + " id \"" + std::to_string(index) + "\";";
+        auto position = Batch::parseLine(line, Batch::Format::Epd, index++);
+        REQUIRE(position.has_value());
+
+        analyser.add(std::move(position.value()));
+    }
+
+    analyser.finish();
+
+    std::set<std::size_t> indices;
+
+    for (const auto &result : results) {
+        REQUIRE(result.bestMove.has_value());
+        REQUIRE(result.depth == 2);
+        REQUIRE(result.id == std::to_string(result.index));
+        indices.insert(result.index);
+    }
+
+    REQUIRE(indices == std::set<std::size_t>{0, 1, 2, 3, 4, 5});
+}
@@ -16,6 +16,7 @@
 #include <map>
 #include <iostream>
 #include <bitset>
+#include <random>
 
 TEST_CASE("A default-constructed board is empty", "[Board][Fundamental]") {
     auto board = Board();
@@ -1081,3 +1082,246 @@ TEST_CASE("test checkmate") {
 
     REQUIRE(board.isCheckMate(board.turn()));
 }
+
+TEST_CASE("Hash is equal for transpositions", "[Board][Hash]") {
+    auto board = Fen::createBoard(Fen::StartingPos).value();
+    auto initialHash = board.hash();
+
+    for (auto uci : {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+        board.makeMove(Move::fromUci(uci).value());
+    }
+
+    REQUIRE(board.hash() == initialHash);
+
+    board.makeMove(Move::fromUci("e2e4").value());
+    auto fenBoard = Fen::createBoard("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1").value();
+    REQUIRE(board.hash() == fenBoard.hash());
+}
+
+TEST_CASE("Hash depends on side to move and castling rights", "[Board][Hash]") {
+    auto board = Fen::createBoard("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1").value();
+    auto otherTurn = Fen::createBoard("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1").value();
+    auto otherRights = Fen::createBoard("r3k2r/8/8/8/8/8/8/R3K2R w Kkq - 0 1").value();
+
+    REQUIRE(board.hash() != otherTurn.hash());
+    REQUIRE(board.hash() != otherRights.hash());
+}
+
+TEST_CASE_MAKE_MOVE("Move making, halfmove clock", "[HalfmoveClock]") {
+    auto board = Fen::createBoard("4k3/8/8/3p4/8/8/4P3/4K1N1 w - - 7 1").value();
+    REQUIRE(board.halfmoveClock() == 7);
+
+    board.makeMove(Move(Square::G1, Square::F3));
+    REQUIRE(board.halfmoveClock() == 8);
+
+    board.makeMove(Move(Square::E8, Square::E7));
+    REQUIRE(board.halfmoveClock() == 9);
+
+    board.makeMove(Move(Square::E2, Square::E4));
+    REQUIRE(board.halfmoveClock() == 0);
+
+    board.makeMove(Move(Square::E7, Square::E6));
+    board.makeMove(Move(Square::E4, Square::D5));
+    REQUIRE(board.halfmoveClock() == 0);
+}
+
+TEST_CASE("Static exchange evaluation", "[Board][SEE]") {
+    auto [fen, uci, threshold, expected] = GENERATE(table<const char*, const char*, int, bool>({
+        // undefended pawn
+        {"4k3/8/8/4p3/8/8/8/4R1K1 w - - 0 1", "e1e5", 100, true},
+        {"4k3/8/8/4p3/8/8/8/4R1K1 w - - 0 1", "e1e5", 101, false},
+        // queen takes a pawn defended by a pawn
+        {"4k3/8/3p4/4p3/8/8/8/4Q1K1 w - - 0 1", "e1e5", 0, false},
+        {"4k3/8/3p4/4p3/8/8/8/4Q1K1 w - - 0 1", "e1e5", -800, true},
+        // doubled rooks win the pawn through the x-ray of the rook behind
+        {"4r1k1/8/8/4p3/8/8/4R3/4R1K1 w - - 0 1", "e2e5", 100, true},
+        {"4r1k1/8/8/4p3/8/8/4R3/4R1K1 w - - 0 1", "e2e5", 101, false},
+        // the king cannot recapture on a defended square
+        {"8/8/8/3k4/4p3/5P2/6B1/6K1 w - - 0 1", "f3e4", 100, true},
+        // quiet moves to an attacked square lose the piece
+        {"4k3/8/3p4/8/8/2B5/8/4K3 w - - 0 1", "c3e5", 0, false}
+    }));
+
+    CAPTURE(fen, uci, threshold);
+
+    auto board = Fen::createBoard(fen).value();
+    REQUIRE(board.see(Move::fromUci(uci).value(), threshold) == expected);
+}
+
+TEST_CASE("Attack info detects checkers and pinned pieces", "[Board][AttackInfo]") {
+    // the knight on d7 is pinned by the bishop on b5, the rook on e2 gives check
+    // https://lichess.org/editor/4k3/3n4/8/1B6/8/8/4R3/4K3_b_-_-_0_1
+    auto board = Fen::createBoard("4k3/3n4/8/1B6/8/8/4R3/4K3 b - - 0 1").value();
+    auto &info = board.attackInfo();
+
+    REQUIRE(info.checkers[1] == (1UL << Square::E2.index()));
+    REQUIRE(info.checkers[0] == 0);
+    REQUIRE(info.pinned[1] == (1UL << Square::D7.index()));
+    REQUIRE(info.pinners[1] == (1UL << Square::B5.index()));
+    REQUIRE(info.pinned[0] == 0);
+
+    REQUIRE(board.isCheck(PieceColor::Black));
+    REQUIRE_FALSE(board.isCheck(PieceColor::White));
+
+    // the attack info is recomputed after a move
+    board.makeMove(Move(Square::E8, Square::F8));
+    REQUIRE(board.attackInfo().checkers[1] == 0);
+    REQUIRE(board.attackInfo().pinned[1] == 0);
+}
+
+TEST_CASE("SEE ignores pinned defenders", "[Board][SEE]") {
+    // the knight on f6 defends d5, but it is pinned to the king by the bishop on c3
+    // https://lichess.org/editor/7k/8/5n2/3p4/8/2B5/8/3RK3_w_-_-_0_1
+    auto board = Fen::createBoard("7k/8/5n2/3p4/8/2B5/8/3RK3 w - - 0 1").value();
+    REQUIRE(board.see(Move(Square::D1, Square::D5), 0));
+
+    // without the pin, the rook is lost for a pawn
+    auto unpinned = Fen::createBoard("k7/8/5n2/3p4/8/2B5/8/3RK3 w - - 0 1").value();
+    REQUIRE_FALSE(unpinned.see(Move(Square::D1, Square::D5), 0));
+}
+
+TEST_CASE("SEE lets the king recapture next to a pinned piece of its own side", "[Board][SEE]") {
+    // after NxN and cxd4 the king takes the pawn, the bishop on e5 also attacks d4 but is pinned by the rook on e8
+    // https://lichess.org/editor/4r2k/8/8/2p1B3/3n4/1N2K3/8/8_w_-_-_0_1
+    auto board = Fen::createBoard("4r2k/8/8/2p1B3/3n4/1N2K3/8/8 w - - 0 1").value();
+    REQUIRE(board.see(Move(Square::B3, Square::D4), 100));
+    REQUIRE_FALSE(board.see(Move(Square::B3, Square::D4), 101));
+}
+
+TEST_CASE("Set-wise pawn moves match per-square generation", "[Board][MoveGen]") {
+    auto fen = GENERATE(
+            std::string(Board::INITIAL_BOARD_FEN),
+            // promotions with and without captures for both colors
+            std::string("1n2k3/P1P5/8/8/8/8/1p5p/4K1N1 w - - 0 1"),
+            std::string("1n2k3/P1P5/8/8/8/8/1p5p/4K1N1 b - - 0 1"),
+            // en passant and blocked double pushes
+            std::string("4k3/8/8/3pP3/8/1p6/1P6/4K3 w - d6 0 1"),
+            std::string("4k3/6p1/6N1/8/3Pp3/8/8/4K3 b - d3 0 1")
+    );
+    auto board = Fen::createBoard(fen).value();
+
+    std::vector<Move> setwise;
+    board.pseudoLegalPawnMoves(setwise);
+
+    std::vector<Move> perSquare;
+    for (unsigned i = 0; i < 64; i++) {
+        auto square = Square::fromIndex(i).value();
+        auto piece = board.piece(square);
+        if (piece && piece->type() == PieceType::Pawn)
+            board.pseudoLegalMovesFrom(square, perSquare);
+    }
+
+    REQUIRE(setwise.size() == perSquare.size());
+    REQUIRE(std::set<Move>(setwise.begin(), setwise.end()) == std::set<Move>(perSquare.begin(), perSquare.end()));
+}
+
+TEST_CASE("Set-wise slider attacks match per-square generation", "[MoveGen][SlidingAttacks]") {
+    auto fen = GENERATE(
+            std::string(Board::INITIAL_BOARD_FEN),
+            std::string("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"),
+            // sliders on the edges and corners of the board
+            std::string("q6r/8/8/R6B/b6Q/8/8/B3K2R w - - 0 1")
+    );
+    auto board = Fen::createBoard(fen).value();
+    auto bitboards = board.getBitboards();
+
+    Board::U64 straight[2] = {bitboards[1] | bitboards[2], bitboards[7] | bitboards[8]};
+    Board::U64 diagonal[2] = {bitboards[1] | bitboards[3], bitboards[7] | bitboards[9]};
+    Board::U64 expectedStraight[2], expectedDiagonal[2], straightAttacks[2], diagonalAttacks[2];
+
+    MoveGenerator::slidingAttacksPerSquare(straight, diagonal, board.getEmptySquares(), expectedStraight,
+                                           expectedDiagonal);
+    MoveGenerator::slidingAttacks(straight, diagonal, board.getEmptySquares(), straightAttacks, diagonalAttacks);
+
+    for (int i = 0; i < 2; i++) {
+        REQUIRE(straightAttacks[i] == expectedStraight[i]);
+        REQUIRE(diagonalAttacks[i] == expectedDiagonal[i]);
+    }
+}
+
+TEST_CASE("PEXT slider backend matches the ray loops", "[MoveGen][Pext]") {
+    if (!MoveGenerator::pextSupported()) {
+        WARN("PEXT is not supported on this CPU");
+        return;
+    }
+
+    auto previous = MoveGenerator::sliderBackend();
+    std::mt19937_64 generator(42);
+
+    for (int i = 0; i < 1000; i++) {
+        // sparse random occupancy, split in own and enemy pieces
+        auto occupied = generator() & generator();
+        auto enemy = occupied & generator();
+        auto empty = ~occupied;
+        auto square = Square::fromIndex(generator() % 64).value();
+
+        REQUIRE(MoveGenerator::setSliderBackend(MoveGenerator::SliderBackend::Loop));
+        auto rook = MoveGenerator::rookMoves(square, empty, enemy);
+        auto bishop = MoveGenerator::bishopMoves(square, empty, enemy);
+
+        REQUIRE(MoveGenerator::setSliderBackend(MoveGenerator::SliderBackend::Pext));
+        REQUIRE(MoveGenerator::rookMoves(square, empty, enemy) == rook);
+        REQUIRE(MoveGenerator::bishopMoves(square, empty, enemy) == bishop);
+    }
+
+    MoveGenerator::setSliderBackend(previous);
+}
+
+TEST_CASE("Mailbox and occupancy stay in sync with the bitboards", "[Board][Mailbox]") {
+    // castling, en passant, captures and a promotion
+    auto board = Fen::createBoard("r3k2r/1P6/8/8/3pP3/8/8/R3K2R b KQkq e3 0 1").value();
+    for (auto uci : {"d4e3", "e1g1", "e8c8", "b7b8q", "c8b8"})
+        board.makeMove(Move::fromUci(uci).value());
+
+    auto &bitboards = board.getBitboards();
+    Board::U64 occupied = 0;
+    for (unsigned i = 0; i < 64; i++) {
+        auto piece = board.piece(i);
+        for (int j = 0; j < 12; j++) {
+            bool set = bitboards[j] & (1UL << i);
+            REQUIRE(set == (piece && piece->bitboardIndex() == j));
+        }
+        if (piece)
+            occupied |= 1UL << i;
+    }
+
+    REQUIRE(board.getEmptySquares() == ~occupied);
+    REQUIRE((board.getEnemySquares(PieceColor::White) | board.getEnemySquares(PieceColor::Black)) == occupied);
+    REQUIRE(board.toString() == ".k.r...r\n........\n........\n........\n........\n....p...\n........\nR....RK.\n");
+}
+
+TEST_CASE("Legal moves are filtered with pins and checkers", "[Board][Legal]") {
+    auto isLegal = [](const char *fen, const char *uci) {
+        return Fen::createBoard(fen).value().isLegal(Move::fromUci(uci).value());
+    };
+
+    // https://lichess.org/editor/4k3/4r3/8/8/8/8/4B3/4K3_w_-_-_0_1
+    REQUIRE_FALSE(isLegal("4k3/4r3/8/8/8/8/4B3/4K3 w - - 0 1", "e2d3"));
+
+    // https://lichess.org/editor/4k3/8/8/8/7b/8/5R2/4K3_w_-_-_0_1
+    REQUIRE_FALSE(isLegal("4k3/8/8/8/7b/8/5R2/4K3 w - - 0 1", "f2f1"));
+
+    // https://lichess.org/editor/4k3/8/8/8/7b/8/5B2/4K3_w_-_-_0_1
+    REQUIRE(isLegal("4k3/8/8/8/7b/8/5B2/4K3 w - - 0 1", "f2g3"));
+    REQUIRE(isLegal("4k3/8/8/8/7b/8/5B2/4K3 w - - 0 1", "f2h4"));
+    REQUIRE_FALSE(isLegal("4k3/8/8/8/7b/8/5B2/4K3 w - - 0 1", "f2e3"));
+
+    // https://lichess.org/editor/4k3/4r3/8/8/8/8/4R3/4K3_w_-_-_0_1
+    REQUIRE(isLegal("4k3/4r3/8/8/8/8/4R3/4K3 w - - 0 1", "e2e7"));
+    REQUIRE(isLegal("4k3/4r3/8/8/8/8/4R3/4K3 w - - 0 1", "e2e5"));
+
+    // https://lichess.org/editor/4k3/4r3/8/8/8/8/8/R3K3_w_-_-_0_1
+    REQUIRE_FALSE(isLegal("4k3/4r3/8/8/8/8/8/R3K3 w - - 0 1", "a1a2"));
+    REQUIRE_FALSE(isLegal("4k3/4r3/8/8/8/8/8/R3K3 w - - 0 1", "e1e2"));
+    REQUIRE(isLegal("4k3/4r3/8/8/8/8/8/R3K3 w - - 0 1", "e1d2"));
+
+    // https://lichess.org/editor/4k3/8/8/8/8/8/R3r3/4K3_w_-_-_0_1
+    REQUIRE(isLegal("4k3/8/8/8/8/8/R3r3/4K3 w - - 0 1", "a2e2"));
+    REQUIRE(isLegal("4k3/8/8/8/8/8/R3r3/4K3 w - - 0 1", "e1f1"));
+    REQUIRE_FALSE(isLegal("4k3/8/8/8/8/8/R3r3/4K3 w - - 0 1", "e1f2"));
+
+    // the en passant capture removes both pawns from the rank of the king
+    // https://lichess.org/editor/8/8/8/KPp4r/8/8/8/7k_w_-_c6_0_1
+    REQUIRE_FALSE(isLegal("8/8/8/KPp4r/8/8/8/7k w - c6 0 1", "b5c6"));
+    REQUIRE(isLegal("8/8/8/KPp4r/8/8/8/7k w - c6 0 1", "b5b6"));
+}
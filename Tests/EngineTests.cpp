@@ -1,4 +1,5 @@
 #include <iostream>
+#include <future>
 #include "catch2/catch.hpp"
 
 #include "TestUtils.hpp"
@@ -45,3 +46,240 @@ TEST_CASE("Engine detects stalemate", "[Engine][Stalemate]") {
 
     testGameEnd(fen, false);
 }
+
+TEST_CASE("Engine detects fifty-move draws", "[Engine][Draw]") {
+    auto engine = ChessEngine();
+
+    auto board = Fen::createBoard("4k3/8/8/8/8/8/8/4K2R w - - 99 80");
+    REQUIRE(board.has_value());
+    REQUIRE_FALSE(engine.isDraw(board.value()));
+
+    board->makeMove(Move(Square::H1, Square::H2));
+    REQUIRE(engine.isDraw(board.value()));
+}
+
+TEST_CASE("Checkmate takes precedence over the fifty-move rule", "[Engine][Draw]") {
+    auto engine = ChessEngine();
+
+    // https://lichess.org/editor/6k1/5ppp/8/8/8/8/8/3R2K1_w_-_-_99_80
+    auto board = Fen::createBoard("6k1/5ppp/8/8/8/8/8/3R2K1 w - - 99 80");
+    REQUIRE(board.has_value());
+
+    board->makeMove(Move(Square::D1, Square::D8));
+    REQUIRE(board->halfmoveClock() == 100);
+    REQUIRE_FALSE(engine.isDraw(board.value()));
+}
+
+/*
+ * Records the progress reported by the engine.
+ */
+class RecordingListener : public SearchListener {
+public:
+
+    void iterationCompleted(const SearchInfo &info) override {
+        iterations.push_back(info);
+    }
+
+    void currentMove(int, const Move &, int) override {}
+
+    std::vector<SearchInfo> iterations;
+};
+
+TEST_CASE("Engine reports every completed iteration", "[Engine][SearchListener]") {
+    auto engine = ChessEngine();
+    RecordingListener listener;
+    engine.setSearchListener(&listener);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo;
+    timeInfo.white = {std::chrono::milliseconds(1000), std::chrono::milliseconds(0)};
+    timeInfo.black = {std::chrono::milliseconds(1000), std::chrono::milliseconds(0)};
+
+    SearchLimits limits;
+    limits.timeInfo = timeInfo;
+
+    auto pv = engine.pv(board.value(), limits);
+
+    REQUIRE_FALSE(listener.iterations.empty());
+
+    for (std::size_t i = 0; i < listener.iterations.size(); i++) {
+        const auto &info = listener.iterations[i];
+        REQUIRE(info.depth == int(i) + 1);
+        REQUIRE(info.selDepth >= info.depth);
+        REQUIRE(info.multiPv == 1);
+        REQUIRE(info.pv.length() > 0);
+
+        if (i > 0)
+            REQUIRE(info.nodes > listener.iterations[i - 1].nodes);
+    }
+
+    const auto &last = listener.iterations.back();
+    // an iteration that is aborted on time is not reported
+    REQUIRE(last.nodes <= engine.statistics()->nodes);
+    REQUIRE(std::equal(pv.begin(), pv.end(), last.pv.begin(), last.pv.end()));
+}
+
+TEST_CASE("Engine respects search limits", "[Engine][SearchLimits]") {
+    auto engine = ChessEngine();
+    RecordingListener listener;
+    engine.setSearchListener(&listener);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    SECTION("Depth") {
+        SearchLimits limits;
+        limits.depth = 3;
+
+        auto pv = engine.pv(board.value(), limits);
+
+        REQUIRE(pv.length() > 0);
+        REQUIRE(listener.iterations.size() == 3);
+        REQUIRE(listener.iterations.back().depth == 3);
+    }
+
+    SECTION("Nodes") {
+        SearchLimits limits;
+        limits.nodes = 20000;
+
+        auto pv = engine.pv(board.value(), limits);
+        auto nodes = engine.statistics()->nodes;
+
+        REQUIRE(pv.length() > 0);
+        REQUIRE(nodes == 20000);
+
+        // a node limited search is reproducible
+        auto other = ChessEngine();
+        auto otherPv = other.pv(board.value(), limits);
+        REQUIRE(other.statistics()->nodes == nodes);
+        REQUIRE(std::equal(pv.begin(), pv.end(), otherPv.begin(), otherPv.end()));
+    }
+
+    SECTION("Move time") {
+        SearchLimits limits;
+        limits.moveTime = std::chrono::milliseconds(100);
+
+        auto pv = engine.pv(board.value(), limits);
+
+        REQUIRE(pv.length() > 0);
+        REQUIRE(engine.statistics()->time < std::chrono::milliseconds(1000));
+    }
+}
+
+TEST_CASE("Engine stops at the requested mate", "[Engine][SearchLimits]") {
+    auto engine = ChessEngine();
+
+    // https://lichess.org/editor/6k1/5ppp/8/8/8/8/5PPP/3R2K1_w_-_-_0_1
+    auto board = Fen::createBoard("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    REQUIRE(board.has_value());
+
+    SearchLimits limits;
+    limits.mate = 1;
+
+    auto pv = engine.pv(board.value(), limits);
+
+    REQUIRE(pv.isMate());
+    REQUIRE(pv.length() == 1);
+    REQUIRE(*pv.begin() == Move(Square::D1, Square::D8));
+}
+
+TEST_CASE("Engine reports the best lines in MultiPV mode", "[Engine][MultiPV]") {
+    auto engine = ChessEngine();
+    RecordingListener listener;
+    engine.setSearchListener(&listener);
+
+    REQUIRE_FALSE(engine.setMultiPv(0));
+    REQUIRE(engine.setMultiPv(3));
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    SearchLimits limits;
+    limits.depth = 3;
+
+    auto pv = engine.pv(board.value(), limits);
+
+    REQUIRE(listener.iterations.size() == 9);
+
+    for (int depth = 1; depth <= 3; depth++) {
+        auto first = listener.iterations.begin() + 3 * (depth - 1);
+
+        for (int k = 0; k < 3; k++) {
+            const auto &info = first[k];
+            REQUIRE(info.depth == depth);
+            REQUIRE(info.multiPv == k + 1);
+
+            if (k > 0) {
+                REQUIRE(info.pv.score() <= first[k - 1].pv.score());
+                REQUIRE_FALSE(*info.pv.begin() == *first[k - 1].pv.begin());
+            }
+        }
+    }
+
+    const auto &best = listener.iterations[6];
+    REQUIRE(std::equal(pv.begin(), pv.end(), best.pv.begin(), best.pv.end()));
+}
+
+TEST_CASE("MultiPV is limited by the number of legal moves", "[Engine][MultiPV]") {
+    auto engine = ChessEngine();
+    RecordingListener listener;
+    engine.setSearchListener(&listener);
+    REQUIRE(engine.setMultiPv(10));
+
+    // https://lichess.org/editor/7k/8/8/8/8/8/8/K7_w_-_-_0_1
+    auto board = Fen::createBoard("7k/8/8/8/8/8/8/K7 w - - 0 1");
+    REQUIRE(board.has_value());
+
+    SearchLimits limits;
+    limits.depth = 1;
+
+    engine.pv(board.value(), limits);
+
+    REQUIRE(listener.iterations.size() == 3);
+}
+
+TEST_CASE("Engine stops an infinite search when signalled", "[Engine][Ponder]") {
+    auto engine = ChessEngine();
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    SearchSignals signals;
+    SearchLimits limits;
+    limits.infinite = true;
+    limits.signals = &signals;
+
+    auto search = std::async(std::launch::async, [&] { return engine.pv(board.value(), limits); });
+    REQUIRE(search.wait_for(std::chrono::milliseconds(200)) == std::future_status::timeout);
+
+    signals.stop = true;
+    REQUIRE(search.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(search.get().length() > 0);
+}
+
+TEST_CASE("Pondering search continues on the clock after a ponder hit", "[Engine][Ponder]") {
+    auto engine = ChessEngine();
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo;
+    timeInfo.white = {std::chrono::milliseconds(1000), std::chrono::milliseconds(0)};
+    timeInfo.black = {std::chrono::milliseconds(1000), std::chrono::milliseconds(0)};
+
+    SearchSignals signals;
+    SearchLimits limits;
+    limits.timeInfo = timeInfo;
+    limits.ponder = true;
+    limits.signals = &signals;
+
+    // the clock is ignored while pondering
+    auto search = std::async(std::launch::async, [&] { return engine.pv(board.value(), limits); });
+    REQUIRE(search.wait_for(std::chrono::milliseconds(300)) == std::future_status::timeout);
+
+    signals.ponderHit = true;
+    REQUIRE(search.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+    REQUIRE(search.get().length() > 0);
+}
@@ -0,0 +1,211 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "Evaluate.h"
+#include "Nnue.hpp"
+#include "Fen.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+static int pawnScore(const char* fen) {
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    auto bitboards = board->getBitboards();
+    return egValue(Evaluate::evaluatePawns(bitboards[5], bitboards[11]));
+}
+
+TEST_CASE("Symmetric pawn structures are equal", "[Evaluate][Pawns]") {
+    // https://lichess.org/editor/4k3/pp3ppp/2p5/8/8/2P5/PP3PPP/4K3_w_-_-_0_1
+    REQUIRE(pawnScore("4k3/pp3ppp/2p5/8/8/2P5/PP3PPP/4K3 w - - 0 1") == 0);
+}
+
+TEST_CASE("Passed pawns are rewarded", "[Evaluate][Pawns]") {
+    // https://lichess.org/editor/4k3/8/1P6/8/8/8/8/4K3_w_-_-_0_1
+    auto advanced = pawnScore("4k3/8/1P6/8/8/8/8/4K3 w - - 0 1");
+    // https://lichess.org/editor/4k3/8/8/8/8/1P6/8/4K3_w_-_-_0_1
+    auto behind = pawnScore("4k3/8/8/8/8/1P6/8/4K3 w - - 0 1");
+
+    REQUIRE(advanced > behind);
+
+    // pawns on adjacent files in front of each other stop both from being passed
+    // https://lichess.org/editor/4k3/2p5/8/1P6/8/8/8/4K3_w_-_-_0_1
+    REQUIRE(pawnScore("4k3/2p5/8/1P6/8/8/8/4K3 w - - 0 1") == 0);
+}
+
+TEST_CASE("Doubled and isolated pawns are penalized", "[Evaluate][Pawns]") {
+    // https://lichess.org/editor/4k3/ppp5/8/8/8/8/PPP5/4K3_w_-_-_0_1
+    auto connected = pawnScore("4k3/ppp5/8/8/8/8/PPP5/4K3 w - - 0 1");
+    // https://lichess.org/editor/4k3/ppp5/8/8/1P6/1P6/1P6/4K3_w_-_-_0_1
+    auto doubled = pawnScore("4k3/ppp5/8/8/1P6/1P6/1P6/4K3 w - - 0 1");
+
+    REQUIRE(connected == 0);
+    REQUIRE(doubled < connected);
+}
+
+TEST_CASE("Pawn hash is independent of other pieces", "[Evaluate][Pawns]") {
+    auto board = Fen::createBoard("4k3/pp6/8/8/8/8/PP6/4K1N1 w - - 0 1").value();
+    auto pawnHash = board.pawnHash();
+
+    board.makeMove(Move(Square::G1, Square::F3));
+    REQUIRE(board.pawnHash() == pawnHash);
+
+    board.makeMove(Move(Square::A7, Square::A6));
+    REQUIRE(board.pawnHash() != pawnHash);
+}
+
+TEST_CASE("Scores pack a middlegame and an endgame value", "[Evaluate][Score]") {
+    auto [mg, eg] = GENERATE(table<int, int>({
+        {0, 0}, {120, -35}, {-120, 35}, {-7, -900}, {32000, -32000}
+    }));
+
+    auto score = makeScore(mg, eg);
+    REQUIRE(mgValue(score) == mg);
+    REQUIRE(egValue(score) == eg);
+
+    auto sum = score + makeScore(5, -5) - makeScore(10, 10);
+    REQUIRE(mgValue(sum) == mg - 5);
+    REQUIRE(egValue(sum) == eg - 15);
+}
+
+TEST_CASE("Game phase is tracked incrementally", "[Evaluate][Phase]") {
+    auto board = Fen::createBoard(Fen::StartingPos).value();
+    REQUIRE(board.phase() == Evaluate::MAX_PHASE);
+
+    // https://lichess.org/editor/4k3/8/8/3q4/4N3/8/8/4K3_w_-_-_0_1
+    board = Fen::createBoard("4k3/8/8/3q4/4N3/8/8/4K3 w - - 0 1").value();
+    REQUIRE(board.phase() == 5);
+
+    board.makeMove(Move(Square::E4, Square::C3));
+    board.makeMove(Move(Square::D5, Square::C5));
+    REQUIRE(board.phase() == 5);
+
+    board.makeMove(Move(Square::C3, Square::A4));
+    board.makeMove(Move(Square::C5, Square::A7));
+    board.makeMove(Move(Square::E1, Square::E2));
+    board.makeMove(Move(Square::A7, Square::A4));
+    REQUIRE(board.phase() == 4);
+}
+
+TEST_CASE("Evaluation is symmetric", "[Evaluate]") {
+    // https://lichess.org/editor/r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R_w_KQkq_-_2_3
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3").value();
+    // the same position with colors reversed
+    auto mirrored = Fen::createBoard("rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3").value();
+
+    REQUIRE(Evaluate::evaluate(board, 1) == Evaluate::evaluate(mirrored, -1));
+    REQUIRE(Evaluate::evaluate(Fen::createBoard(Fen::StartingPos).value(), 1) == 0);
+}
+
+static std::string writeRandomNetwork(uint32_t hidden) {
+    auto path = std::string("test-network.nnue");
+    auto stream = std::ofstream(path, std::ios::binary);
+
+    auto generator = std::mt19937(42);
+    auto distribution = std::uniform_int_distribution<int>(-8, 8);
+    auto write = [&stream](const auto& value) {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    stream.write("PNUE", 4);
+    write(uint32_t(1));
+    write(hidden);
+
+    for (uint32_t i = 0; i < hidden; i++)
+        write(int16_t(distribution(generator) * 4));
+
+    for (std::size_t i = 0; i < std::size_t(Nnue::FEATURES) * hidden; i++)
+        write(int16_t(distribution(generator)));
+
+    for (uint32_t i = 0; i < 2 * hidden; i++)
+        write(int8_t(distribution(generator)));
+
+    write(int32_t(100));
+    return path;
+}
+
+TEST_CASE("Network accumulators are updated incrementally", "[Evaluate][Nnue]") {
+    auto path = writeRandomNetwork(32);
+    REQUIRE(Nnue::load(path));
+    std::remove(path.c_str());
+
+    auto board = Fen::createBoard("r3k2r/1pp2ppp/8/3pP3/8/8/1PP2PPP/R3K2R w KQkq d6 0 1").value();
+    auto accumulators = Nnue::Accumulators();
+    accumulators.reset();
+    (void) accumulators.evaluate(board);
+
+    // en passant, castling, king moves, captures and a promotion
+    for (auto uci : {"e5d6", "c7d6", "e1g1", "e8c8", "a1a7", "d8d7", "a7b7", "c8b7", "b2b4", "d6d5",
+                     "b4b5", "d5d4", "b5b6", "d4d3", "b6a7", "d3c2", "a7a8q", "c2c1n"}) {
+        board.makeMove(Move::fromUci(uci).value());
+        accumulators.push(board);
+
+        auto fresh = Nnue::Accumulators();
+        fresh.reset();
+
+        CAPTURE(uci);
+        REQUIRE(accumulators.evaluate(board) == fresh.evaluate(board));
+    }
+
+    Nnue::unload();
+}
+
+TEST_CASE("Handcrafted evaluation is used without a network", "[Evaluate][Nnue]") {
+    REQUIRE_FALSE(Nnue::isLoaded());
+    REQUIRE_FALSE(Nnue::load("does-not-exist.nnue"));
+
+    auto board = Fen::createBoard("4k3/8/8/3q4/4N3/8/8/4K3 w - - 0 1").value();
+    auto accumulators = Nnue::Accumulators();
+    accumulators.reset();
+
+    REQUIRE(Evaluate::evaluate(board, 1, accumulators) == Evaluate::evaluate(board, 1));
+}
+
+TEST_CASE("Evaluations are cached", "[Evaluate][Cache]") {
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3").value();
+
+    auto score = Evaluate::evaluate(board, 1);
+
+    Evaluate::resetStatistics();
+    REQUIRE(Evaluate::evaluate(board, -1) == -score);
+
+    auto statistics = Evaluate::statistics();
+    REQUIRE(statistics.evaluations == 1);
+    REQUIRE(statistics.cacheHits == 1);
+}
+
+TEST_CASE("Lazy evaluation returns early outside the window", "[Evaluate][Lazy]") {
+    // white is a queen up, so the pawn structure can't change the outcome of a window around equality
+    // https://lichess.org/editor/4k3/1p1p1p1p/8/8/8/8/PP4PP/3QK3_w_-_-_0_1
+    auto board = Fen::createBoard("4k3/1p1p1p1p/8/8/8/8/PP4PP/3QK3 w - - 0 1").value();
+
+    auto lazy = Evaluate::evaluate(board, 1, -50, 50);
+    REQUIRE(lazy >= 50);
+
+    auto exact = Evaluate::evaluate(board, 1);
+    REQUIRE(exact >= 50);
+
+    // exact scores are used within the window
+    REQUIRE(Evaluate::evaluate(board, 1, exact - 10, exact + 10) == exact);
+}
+
+TEST_CASE("Mobility is symmetric and rewards free pieces", "[Evaluate][Mobility]") {
+    auto start = Fen::createBoard(Board::INITIAL_BOARD_FEN).value();
+    REQUIRE(Evaluate::evaluateMobility(start) == 0);
+
+    // the white bishop on d4 has open diagonals, the black bishop on a8 is locked in by its own pawn
+    // https://lichess.org/editor/b3k3/1p6/8/8/3B4/8/8/4K3_w_-_-_0_1
+    auto board = Fen::createBoard("b3k3/1p6/8/8/3B4/8/8/4K3 w - - 0 1").value();
+    REQUIRE(mgValue(Evaluate::evaluateMobility(board)) > 0);
+}
+
+TEST_CASE("Black piece-square scores mirror white", "[Evaluate][PieceSquare]") {
+    for (int bitboard = 0; bitboard < 6; bitboard++) {
+        for (unsigned square = 0; square < 64; square++)
+            REQUIRE(Evaluate::pieceSquareScore(bitboard + 6, square ^ 56) == -Evaluate::pieceSquareScore(bitboard, square));
+    }
+}
@@ -115,3 +115,88 @@ TEST_CASE("En passant square is correctly parsed", "[Fen][EnPassant]") {
     auto board = optBoard.value();
     REQUIRE(board.enPassantSquare() == ep);
 }
+
+TEST_CASE("Halfmove clock is correctly parsed", "[Fen][HalfmoveClock]") {
+    auto [fen, clock] = GENERATE(table<const char*, unsigned>({
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0},
+        {"8/8/8/8/8/8/8/8 b - - 42 60", 42}
+    }));
+
+    CAPTURE(fen, clock);
+
+    auto optBoard = Fen::createBoard(fen);
+    REQUIRE(optBoard.has_value());
+    REQUIRE(optBoard->halfmoveClock() == clock);
+}
+
+TEST_CASE("Fullmove number is correctly parsed", "[Fen]") {
+    auto optBoard = Fen::createBoard("8/8/8/8/8/8/8/8 b - - 42 60");
+    REQUIRE(optBoard.has_value());
+    REQUIRE(optBoard->fullmoveNumber() == 60);
+
+    // the move counters are optional
+    optBoard = Fen::createBoard("8/8/8/8/8/8/8/8 b - -");
+    REQUIRE(optBoard.has_value());
+    REQUIRE(optBoard->halfmoveClock() == 0);
+    REQUIRE(optBoard->fullmoveNumber() == 1);
+
+    REQUIRE_FALSE(Fen::createBoard("8/8/8/8/8/8/8/8 b - - x 1").has_value());
+    REQUIRE_FALSE(Fen::createBoard("8/8/8/8/8/8/8/8 b - - 0 0").has_value());
+}
+
+TEST_CASE("Fullmove number is incremented after a move of black", "[Fen]") {
+    auto board = Fen::createBoard(Fen::StartingPos).value();
+
+    board.makeMove(Move(Square::E2, Square::E4));
+    REQUIRE(board.fullmoveNumber() == 1);
+
+    board.makeMove(Move(Square::E7, Square::E5));
+    REQUIRE(board.fullmoveNumber() == 2);
+}
+
+TEST_CASE("Boards are converted to FEN", "[Fen]") {
+    auto fen = GENERATE(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "r3k2r/8/8/8/8/8/8/R3K2R b Kq - 5 40",
+        "k7/2B5/7p/1q3P2/8/3N4/8/5r2 w - - 0 1"
+    );
+
+    CAPTURE(fen);
+
+    auto optBoard = Fen::createBoard(fen);
+    REQUIRE(optBoard.has_value());
+    REQUIRE(Fen::toFen(optBoard.value()) == fen);
+}
+
+TEST_CASE("EPD records are parsed", "[Fen][Epd]") {
+    auto epd = Fen::parseEpd(
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - bm Bb5; id \"ruy; lopez\"; hmvc 2; fmvn 3;");
+    REQUIRE(epd.has_value());
+
+    REQUIRE(epd->board.turn() == PieceColor::White);
+    REQUIRE(epd->board.halfmoveClock() == 2);
+    REQUIRE(epd->board.fullmoveNumber() == 3);
+    REQUIRE(epd->operation("bm") == "Bb5");
+    REQUIRE(epd->operation("id") == "ruy; lopez");
+    REQUIRE_FALSE(epd->operation("am").has_value());
+
+    REQUIRE(Fen::toFen(epd->board) == "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+}
+
+TEST_CASE("EPD records with FEN counters are parsed", "[Fen][Epd]") {
+    auto epd = Fen::parseEpd("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3 id \"ruy\"; bm Bb5;");
+    REQUIRE(epd.has_value());
+
+    REQUIRE(epd->board.halfmoveClock() == 2);
+    REQUIRE(epd->board.fullmoveNumber() == 3);
+    REQUIRE(epd->operation("id") == "ruy");
+    REQUIRE(epd->operation("bm") == "Bb5");
+
+    // operations override the counters
+    epd = Fen::parseEpd("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3 hmvc 4;");
+    REQUIRE(epd.has_value());
+    REQUIRE(epd->board.halfmoveClock() == 4);
+
+    REQUIRE_FALSE(Fen::parseEpd("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 0 id \"ruy\";"));
+}
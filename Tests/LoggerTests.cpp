@@ -0,0 +1,84 @@
+#include "catch2/catch.hpp"
+
+#include "Logger.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string readFile(const std::string &path) {
+    std::ifstream file(path);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+TEST_CASE("Logger writes messages in order", "[Logger]") {
+    auto path = std::string("logger-test.txt");
+
+    {
+        Logger logger;
+        REQUIRE(logger.open(path));
+        REQUIRE(logger.enabled(Logger::Level::Debug));
+
+        logger.write(Logger::Level::Info, "> go depth ", 5);
+        logger.write(Logger::Level::Error, "bestmove ", "e2e4");
+    }
+
+    REQUIRE(readFile(path) == "> go depth 5\nbestmove e2e4\n");
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Logger discards messages below its level", "[Logger]") {
+    auto path = std::string("logger-level-test.txt");
+
+    Logger logger;
+    REQUIRE_FALSE(logger.enabled(Logger::Level::Error));
+
+    REQUIRE(logger.open(path));
+    logger.setLevel(Logger::Level::Info);
+    REQUIRE_FALSE(logger.enabled(Logger::Level::Debug));
+
+    logger.write(Logger::Level::Debug, "board");
+    logger.write(Logger::Level::Info, "info");
+
+    // an empty path disables the log
+    REQUIRE(logger.open(""));
+    REQUIRE_FALSE(logger.enabled(Logger::Level::Error));
+    logger.write(Logger::Level::Error, "error");
+
+    REQUIRE(readFile(path) == "info\n");
+    std::remove(path.c_str());
+}
+
+TEST_CASE("Logger accepts messages from several threads", "[Logger]") {
+    auto path = std::string("logger-threads-test.txt");
+
+    {
+        Logger logger;
+        REQUIRE(logger.open(path));
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&logger, t] {
+                for (int i = 0; i < 500; i++)
+                    logger.write(Logger::Level::Info, t, ' ', i);
+            });
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    // the buffer holds more messages than were written, so none are dropped
+    std::ifstream file(path);
+    int lines = 0;
+    for (std::string line; std::getline(file, line);)
+        lines++;
+
+    REQUIRE(lines == 2000);
+    std::remove(path.c_str());
+}
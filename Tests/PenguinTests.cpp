@@ -0,0 +1,204 @@
+#include "catch2/catch.hpp"
+
+#include "Penguin.h"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <thread>
+
+using EngineHandle = std::unique_ptr<penguin_engine, decltype(&penguin_destroy)>;
+
+static EngineHandle createEngine() {
+    return {penguin_create(), &penguin_destroy};
+}
+
+TEST_CASE("Positions are set from a FEN and legal moves", "[Penguin]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    REQUIRE(penguin_set_position(engine.get(), nullptr, "e2e4 e7e5 g1f3") == PENGUIN_OK);
+
+    char fen[128];
+    auto length = penguin_get_fen(engine.get(), fen, sizeof(fen));
+    REQUIRE(std::string(fen) == "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+    REQUIRE(length == std::string(fen).size());
+
+    // an invalid FEN or move leaves the position unchanged
+    REQUIRE(penguin_set_position(engine.get(), "not a fen", nullptr) == PENGUIN_INVALID_FEN);
+    REQUIRE(penguin_set_position(engine.get(), nullptr, "e2e4 e2e4") == PENGUIN_ILLEGAL_MOVE);
+    REQUIRE(penguin_set_position(engine.get(), nullptr, "e2e5") == PENGUIN_ILLEGAL_MOVE);
+
+    penguin_get_fen(engine.get(), fen, sizeof(fen));
+    REQUIRE(std::string(fen) == "rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+}
+
+TEST_CASE("Legal moves and perft", "[Penguin]") {
+    auto engine = createEngine();
+
+    penguin_move moves[PENGUIN_MAX_MOVES];
+    REQUIRE(penguin_legal_moves(engine.get(), moves, PENGUIN_MAX_MOVES) == 20);
+    REQUIRE(penguin_perft(engine.get(), 3) == 8902);
+
+    // the king is in check, only the moves that get out of check are legal
+    REQUIRE(penguin_set_position(engine.get(), "4k3/8/8/8/8/8/3PPq2/4K3 w - - 0 1", nullptr) == PENGUIN_OK);
+    REQUIRE(penguin_legal_moves(engine.get(), moves, 1) == 2);
+    REQUIRE((std::string(moves[0].uci) == "e1f2" || std::string(moves[0].uci) == "e1d1"));
+
+    REQUIRE(penguin_set_position(engine.get(), "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                                 nullptr) == PENGUIN_OK);
+    REQUIRE(penguin_perft(engine.get(), 2) == 2039);
+}
+
+// the PV of an info is only valid during the callback, so only its first move is kept
+static void recordInfo(const penguin_info *info, void *userData) {
+    auto copy = *info;
+    copy.pv = nullptr;
+    static_cast<std::vector<std::pair<penguin_info, std::string>> *>(userData)->emplace_back(copy, info->pv[0].uci);
+}
+
+TEST_CASE("Searches report their iterations and result", "[Penguin]") {
+    auto engine = createEngine();
+    std::vector<std::pair<penguin_info, std::string>> infos;
+    penguin_set_info_callback(engine.get(), recordInfo, &infos);
+
+    // https://lichess.org/editor/6k1/5ppp/8/8/8/8/8/R5K1_w_-_-_0_1
+    REQUIRE(penguin_set_position(engine.get(), "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", nullptr) == PENGUIN_OK);
+
+    penguin_limits limits{};
+    limits.depth = 3;
+
+    penguin_result result;
+    REQUIRE(penguin_search(engine.get(), &limits, &result) == PENGUIN_OK);
+
+    REQUIRE(std::string(result.best_move.uci) == "a1a8");
+    REQUIRE(result.score.mate == 1);
+    REQUIRE(result.depth == 1);
+    REQUIRE(result.nodes > 0);
+
+    REQUIRE(infos.size() == 1);
+    REQUIRE(infos[0].first.score.mate == 1);
+    REQUIRE(infos[0].first.pv_length == 1);
+    REQUIRE(infos[0].second == "a1a8");
+}
+
+TEST_CASE("Engines search independently on different threads", "[Penguin]") {
+    auto search = [](const char *fen) {
+        auto engine = createEngine();
+        penguin_set_position(engine.get(), fen, nullptr);
+
+        penguin_limits limits{};
+        limits.depth = 3;
+
+        penguin_result result;
+        penguin_search(engine.get(), &limits, &result);
+        return std::string(result.best_move.uci);
+    };
+
+    auto fen = "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
+    auto expected = search(fen);
+
+    std::vector<std::future<std::string>> results;
+    for (int i = 0; i < 4; i++)
+        results.push_back(std::async(std::launch::async, search, fen));
+
+    for (auto &result : results)
+        REQUIRE(result.get() == expected);
+}
+
+TEST_CASE("Infinite searches end when stopped", "[Penguin]") {
+    auto engine = createEngine();
+    REQUIRE(penguin_set_position(engine.get(), nullptr, "e2e4") == PENGUIN_OK);
+
+    penguin_limits limits{};
+    limits.infinite = 1;
+
+    auto search = std::async(std::launch::async, [&] {
+        penguin_result result;
+        penguin_search(engine.get(), &limits, &result);
+        return result;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    penguin_stop(engine.get());
+
+    REQUIRE(search.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    REQUIRE(std::string(search.get().best_move.uci).size() == 4);
+}
+
+/*
+ * Holds the first info callback of the searches of a handle until it is released.
+ */
+struct CallbackGate {
+    std::promise<void> entered;
+    std::shared_future<void> released;
+    bool first = true;
+};
+
+TEST_CASE("A stop while the search is started ends the search", "[Penguin]") {
+    auto engine = createEngine();
+    // https://lichess.org/editor/8/5k2/8/3p4/3P4/8/5K2/8_w_-_-_0_1
+    REQUIRE(penguin_set_position(engine.get(), "8/5k2/8/3p4/3P4/8/5K2/8 w - - 0 1", nullptr) == PENGUIN_OK);
+
+    // the first search holds the handle in its info callback, so the second search waits to start
+    std::promise<void> release;
+    CallbackGate gate{{}, release.get_future().share()};
+    auto entered = gate.entered.get_future();
+
+    penguin_set_info_callback(engine.get(), [](const penguin_info *, void *userData) {
+        auto gate = static_cast<CallbackGate *>(userData);
+
+        if (std::exchange(gate->first, false)) {
+            gate->entered.set_value();
+            gate->released.wait();
+        }
+    }, &gate);
+
+    penguin_limits first{};
+    first.depth = 1;
+
+    auto firstSearch = std::async(std::launch::async, [&] {
+        penguin_result result;
+        return penguin_search(engine.get(), &first, &result);
+    });
+
+    entered.wait();
+
+    penguin_limits infinite{};
+    infinite.infinite = 1;
+
+    auto secondSearch = std::async(std::launch::async, [&] {
+        penguin_result result;
+        penguin_search(engine.get(), &infinite, &result);
+        return result;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    penguin_stop(engine.get());
+    release.set_value();
+
+    REQUIRE(firstSearch.get() == PENGUIN_OK);
+    REQUIRE(secondSearch.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    REQUIRE(std::string(secondSearch.get().best_move.uci).size() == 4);
+}
+
+TEST_CASE("A stop after the search returned does not end the next search", "[Penguin]") {
+    auto engine = createEngine();
+    // https://lichess.org/editor/8/5k2/8/3p4/3P4/8/5K2/8_w_-_-_0_1
+    REQUIRE(penguin_set_position(engine.get(), "8/5k2/8/3p4/3P4/8/5K2/8 w - - 0 1", nullptr) == PENGUIN_OK);
+
+    penguin_limits limits{};
+    limits.depth = 1;
+
+    penguin_result result;
+    REQUIRE(penguin_search(engine.get(), &limits, &result) == PENGUIN_OK);
+
+    penguin_stop(engine.get());
+
+    limits.depth = 4;
+    REQUIRE(penguin_search(engine.get(), &limits, &result) == PENGUIN_OK);
+    REQUIRE(result.depth == 4);
+}
+
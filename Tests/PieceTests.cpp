@@ -72,3 +72,15 @@ TEST_CASE("PieceColor can be inverted correctly", "[Piece][Fundamental]") {
     REQUIRE((!PieceColor::White) == PieceColor::Black);
     REQUIRE((!PieceColor::Black) == PieceColor::White);
 }
+
+TEST_CASE("Pieces map to their bitboard index", "[Piece][Fundamental]") {
+    static_assert(sizeof(Piece) == 1);
+    static_assert(Piece::WhiteKing.bitboardIndex() == 0);
+    static_assert(Piece::BlackPawn.bitboardIndex() == 11);
+
+    for (int i = 0; i < 12; i++) {
+        auto piece = Piece::fromBitboardIndex(i);
+        REQUIRE(Piece(piece.color(), piece.type()) == piece);
+        REQUIRE(piece.bitboardIndex() == i);
+    }
+}
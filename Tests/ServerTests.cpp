@@ -0,0 +1,175 @@
+#include "catch2/catch.hpp"
+
+#include "SearchPool.hpp"
+#include "Server.hpp"
+
+#include <future>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <cstring>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+TEST_CASE("Waiting searches start in order of remaining clock time", "[Server]") {
+    std::vector<int> order;
+    std::mutex mutex;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+
+    {
+        auto pool = SearchPool(1);
+
+        // keeps the only thread busy until all searches are queued
+        pool.submit(std::nullopt, [released] { released.wait(); });
+
+        auto submit = [&](std::optional<std::chrono::milliseconds> remainingTime, int id) {
+            pool.submit(remainingTime, [&, id] {
+                std::lock_guard lock(mutex);
+                order.push_back(id);
+            });
+        };
+
+        submit(std::nullopt, 1);
+        submit(std::chrono::milliseconds(3000), 2);
+        submit(std::chrono::milliseconds(1000), 3);
+        submit(std::nullopt, 4);
+        submit(std::chrono::milliseconds(2000), 5);
+
+        release.set_value();
+    }
+
+    REQUIRE(order == std::vector<int>{3, 5, 2, 1, 4});
+}
+
+static int connectTo(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        close(client);
+        return -1;
+    }
+
+    return client;
+}
+
+static bool sendCommands(int client, const std::string &commands) {
+    return send(client, commands.data(), commands.size(), 0) == static_cast<ssize_t>(commands.size());
+}
+
+static std::string readUntilBestMove(int client) {
+    std::string output;
+    char buffer[1024];
+
+    while (output.find("bestmove") == std::string::npos || output.back() != '\n') {
+        auto received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+            break;
+
+        output.append(buffer, received);
+    }
+
+    return output;
+}
+
+/*
+ * Connects to the server, sends the commands and returns the output up to and including the best move. Sessions run
+ * concurrently, so failures show up as missing output instead of assertions.
+ */
+static std::string uciSession(const std::string &path, const std::string &commands) {
+    int client = connectTo(path);
+    std::string output;
+
+    if (client >= 0 && sendCommands(client, commands))
+        output = readUntilBestMove(client);
+
+    if (client >= 0)
+        close(client);
+
+    return output;
+}
+
+TEST_CASE("The server plays independent sessions", "[Server]") {
+    auto path = "/tmp/penguin-test-" + std::to_string(getpid()) + ".sock";
+
+    auto server = Server(2);
+    REQUIRE(server.listenUnix(path));
+    auto running = std::async(std::launch::async, [&] { server.run(); });
+
+    // https://lichess.org/editor/6k1/5ppp/8/8/8/8/8/R5K1_w_-_-_0_1
+    auto mate = std::async(std::launch::async, uciSession, path,
+                           "position fen 6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1\ngo depth 3\n");
+    // https://lichess.org/editor/1r4k1/5ppp/8/8/8/8/5PPP/6K1_b_-_-_0_1
+    auto mated = std::async(std::launch::async, uciSession, path,
+                            "position fen 1r4k1/5ppp/8/8/8/8/5PPP/6K1 b - - 0 1\ngo depth 3\n");
+    auto illegal = uciSession(path, "position fen not a fen\n");
+
+    REQUIRE(mate.get().find("bestmove a1a8") != std::string::npos);
+    REQUIRE(mated.get().find("bestmove b8b1") != std::string::npos);
+    REQUIRE(illegal.find("info string error") != std::string::npos);
+
+    server.stop();
+    REQUIRE(running.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+}
+
+TEST_CASE("Pondering sessions don't keep the threads from sessions on a clock", "[Server]") {
+    auto path = "/tmp/penguin-test-ponder-" + std::to_string(getpid()) + ".sock";
+    auto position = std::string("position fen r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10\n");
+
+    auto server = Server(1);
+    REQUIRE(server.listenUnix(path));
+    auto running = std::async(std::launch::async, [&] { server.run(); });
+
+    int pondering = connectTo(path);
+    REQUIRE(pondering >= 0);
+    REQUIRE(sendCommands(pondering, position + "go ponder wtime 100000 btime 100000\n"));
+
+    // the pondering search has the only thread by now
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    auto start = std::chrono::steady_clock::now();
+    auto clocked = uciSession(path, position + "go wtime 1000 btime 1000\n");
+
+    REQUIRE(clocked.find("bestmove") != std::string::npos);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+    // the interrupted search still sends its best move once it may
+    REQUIRE(sendCommands(pondering, "stop\n"));
+    REQUIRE(readUntilBestMove(pondering).find("bestmove") != std::string::npos);
+    close(pondering);
+
+    server.stop();
+    REQUIRE(running.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+}
+
+TEST_CASE("Searches of disconnected sessions are stopped", "[Server]") {
+    auto path = "/tmp/penguin-test-disconnect-" + std::to_string(getpid()) + ".sock";
+    auto position = std::string("position fen r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10\n");
+
+    auto server = Server(1);
+    REQUIRE(server.listenUnix(path));
+    auto running = std::async(std::launch::async, [&] { server.run(); });
+
+    // a search with a long move time that would have the only thread for a minute
+    int gone = connectTo(path);
+    REQUIRE(gone >= 0);
+    REQUIRE(sendCommands(gone, position + "go movetime 60000\n"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    close(gone);
+
+    auto start = std::chrono::steady_clock::now();
+    auto clocked = uciSession(path, position + "go depth 2\n");
+
+    REQUIRE(clocked.find("bestmove") != std::string::npos);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+
+    server.stop();
+    REQUIRE(running.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+}
@@ -78,3 +78,12 @@ TEST_CASE("Squares stream their name correctly", "[Square][Fundamental]") {
     stream << square;
     REQUIRE(stream.str() == name);
 }
+
+TEST_CASE("Squares are compact constant values", "[Square][Fundamental]") {
+    static_assert(sizeof(Square) == 1);
+    static_assert(Square(28) == Square::E4);
+    static_assert(Square::E4.file() == 4 && Square::E4.rank() == 3);
+
+    for (unsigned i = 0; i < 64; i++)
+        REQUIRE(Square(i) == Square::fromIndex(i).value());
+}
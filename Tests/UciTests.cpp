@@ -0,0 +1,445 @@
+#include "catch2/catch.hpp"
+
+#include "Uci.hpp"
+#include "UciTokens.hpp"
+#include "Fen.hpp"
+#include "SearchPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+ * Commands for a session, written by the test while the session reads them. Reading blocks until a command is written
+ * or the input is closed.
+ */
+class CommandInput : public std::streambuf {
+public:
+
+    void write(const std::string &line) {
+        {
+            std::lock_guard lock(mutex_);
+            lines_ += line + '\n';
+        }
+
+        condition_.notify_all();
+    }
+
+    void close() {
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+
+        condition_.notify_all();
+    }
+
+protected:
+
+    int_type underflow() override {
+        std::unique_lock lock(mutex_);
+        condition_.wait(lock, [this] { return !lines_.empty() || closed_; });
+
+        if (lines_.empty())
+            return traits_type::eof();
+
+        buffer_ = std::move(lines_);
+        lines_.clear();
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + buffer_.size());
+        return traits_type::to_int_type(buffer_.front());
+    }
+
+private:
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::string lines_;
+    std::string buffer_;
+    bool closed_ = false;
+};
+
+/*
+ * Output of a session, which is written by the command and search threads of the session while the test reads it.
+ */
+class CommandOutput : public std::streambuf {
+public:
+
+    // waits until the output contains the given text the given number of times
+    bool waitFor(std::string_view text, int count = 1) {
+        std::unique_lock lock(mutex_);
+        return condition_.wait_for(lock, std::chrono::seconds(10), [&] { return countLocked(text) >= count; });
+    }
+
+    int count(std::string_view text) {
+        std::lock_guard lock(mutex_);
+        return countLocked(text);
+    }
+
+protected:
+
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            auto ch = traits_type::to_char_type(c);
+            xsputn(&ch, 1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override {
+        {
+            std::lock_guard lock(mutex_);
+            text_.append(s, n);
+        }
+
+        condition_.notify_all();
+        return n;
+    }
+
+private:
+
+    int countLocked(std::string_view text) const {
+        int count = 0;
+
+        for (auto pos = text_.find(text); pos != std::string::npos; pos = text_.find(text, pos + text.size()))
+            count++;
+
+        return count;
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::string text_;
+};
+
+/*
+ * Plays a fixed line instead of searching, and records the positions it was asked to search. A search that waits for
+ * its signals only ends on stop or ponderhit, like a real pondering or infinite search.
+ */
+class FakeEngine : public Engine {
+public:
+
+    FakeEngine(std::vector<Move> line, bool waitForSignals) : line_(std::move(line)), waitForSignals_(waitForSignals) {}
+
+    std::string name() const override { return "Fake"; }
+
+    std::string version() const override { return "1"; }
+
+    std::string author() const override { return "Tests"; }
+
+    void newGame() override {}
+
+    PrincipalVariation pv(const Board &board, const SearchLimits &limits) override {
+        {
+            std::lock_guard lock(mutex_);
+            fens_.push_back(Fen::toFen(board));
+            historySizes_.push_back(historySize_);
+        }
+
+        condition_.notify_all();
+
+        while (waitForSignals_ && !limits.signals->stop && !limits.signals->ponderHit)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        return PrincipalVariation(line_, board.turn(), 0, line_.empty());
+    }
+
+    void setGameHistory(const std::vector<Board::U64> &history) override {
+        std::lock_guard lock(mutex_);
+        historySize_ = history.size();
+    }
+
+    // waits until the given number of searches were started
+    bool waitForSearches(std::size_t count) {
+        std::unique_lock lock(mutex_);
+        return condition_.wait_for(lock, std::chrono::seconds(10), [&] { return fens_.size() >= count; });
+    }
+
+    std::vector<std::string> fens() {
+        std::lock_guard lock(mutex_);
+        return fens_;
+    }
+
+    std::vector<std::size_t> historySizes() {
+        std::lock_guard lock(mutex_);
+        return historySizes_;
+    }
+
+private:
+
+    std::vector<Move> line_;
+    bool waitForSignals_;
+    std::size_t historySize_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<std::string> fens_;
+    std::vector<std::size_t> historySizes_;
+};
+
+/*
+ * A session that runs on its own thread, either with its own search thread or on a pool like a session of a server.
+ */
+class UciSession {
+public:
+
+    explicit UciSession(std::vector<Move> line = {Move(Square::E2, Square::E4), Move(Square::E7, Square::E5)},
+                        bool waitForSignals = false, bool onPool = false) {
+        auto engine = std::make_unique<FakeEngine>(std::move(line), waitForSignals);
+        engine_ = engine.get();
+
+        if (onPool) {
+            pool_ = std::make_unique<SearchPool>(1);
+            uci_ = std::make_unique<Uci>(std::move(engine), in_, out_, *pool_);
+        } else {
+            uci_ = std::make_unique<Uci>(std::move(engine), in_, out_);
+        }
+
+        thread_ = std::thread([this] { uci_->run(); });
+    }
+
+    ~UciSession() {
+        finish();
+    }
+
+    // ends the input, the session finishes its search and returns from run
+    void finish() {
+        input.close();
+
+        if (thread_.joinable())
+            thread_.join();
+    }
+
+    void send(const std::string &line) {
+        input.write(line);
+    }
+
+    FakeEngine &engine() {
+        return *engine_;
+    }
+
+    CommandInput input;
+    CommandOutput output;
+
+private:
+
+    std::istream in_{&input};
+    std::ostream out_{&output};
+    FakeEngine *engine_;
+    std::unique_ptr<SearchPool> pool_;
+    std::unique_ptr<Uci> uci_;
+    std::thread thread_;
+};
+
+// time in which a best move that is sent too early would show up
+static constexpr auto SETTLE_TIME = std::chrono::milliseconds(100);
+
+TEST_CASE("Searches send exactly one best move", "[Uci]") {
+    auto onPool = GENERATE(false, true);
+    CAPTURE(onPool);
+
+    UciSession session({Move(Square::E2, Square::E4), Move(Square::E7, Square::E5)}, false, onPool);
+    session.send("position startpos");
+    session.send("go depth 1");
+
+    REQUIRE(session.output.waitFor("bestmove e2e4 ponder e7e5"));
+
+    session.finish();
+    REQUIRE(session.output.count("bestmove") == 1);
+}
+
+TEST_CASE("Pondering and infinite searches send their best move only when allowed", "[Uci]") {
+    auto [go, allow] = GENERATE(table<const char *, const char *>({
+        {"go ponder", "ponderhit"},
+        {"go ponder", "stop"},
+        {"go infinite", "stop"}
+    }));
+    // whether the search is still running when it is allowed to send its best move, or waits for that with its result
+    auto waitForSignals = GENERATE(false, true);
+    auto onPool = GENERATE(false, true);
+    CAPTURE(go, allow, waitForSignals, onPool);
+
+    UciSession session({Move(Square::E2, Square::E4), Move(Square::E7, Square::E5)}, waitForSignals, onPool);
+    session.send("position startpos");
+    session.send(go);
+
+    REQUIRE(session.engine().waitForSearches(1));
+    std::this_thread::sleep_for(SETTLE_TIME);
+    REQUIRE(session.output.count("bestmove") == 0);
+
+    session.send(allow);
+    REQUIRE(session.output.waitFor("bestmove e2e4 ponder e7e5"));
+
+    // the next command must not send the best move again
+    session.send("isready");
+    REQUIRE(session.output.waitFor("readyok"));
+
+    session.finish();
+    REQUIRE(session.output.count("bestmove") == 1);
+}
+
+TEST_CASE("A pondering search that is never allowed sends its best move when the session ends", "[Uci]") {
+    auto onPool = GENERATE(false, true);
+    CAPTURE(onPool);
+
+    UciSession session({Move(Square::E2, Square::E4)}, true, onPool);
+    session.send("position startpos");
+    session.send("go ponder");
+    REQUIRE(session.engine().waitForSearches(1));
+
+    session.finish();
+    REQUIRE(session.output.count("bestmove") == 1);
+}
+
+TEST_CASE("A search without legal moves sends the null move", "[Uci]") {
+    auto [go, allow] = GENERATE(table<const char *, const char *>({
+        {"go depth 1", ""},
+        {"go infinite", "stop"},
+        {"go ponder", "ponderhit"}
+    }));
+    auto onPool = GENERATE(false, true);
+    CAPTURE(go, allow, onPool);
+
+    // https://lichess.org/editor/3R2k1/5ppp/8/8/8/8/8/6K1_b_-_-_1_1
+    UciSession session({}, false, onPool);
+    session.send("position fen 3R2k1/5ppp/8/8/8/8/8/6K1 b - - 1 1");
+    session.send(go);
+    REQUIRE(session.engine().waitForSearches(1));
+
+    if (*allow != '\0') {
+        std::this_thread::sleep_for(SETTLE_TIME);
+        REQUIRE(session.output.count("bestmove") == 0);
+        session.send(allow);
+    }
+
+    REQUIRE(session.output.waitFor("bestmove 0000"));
+
+    session.finish();
+    REQUIRE(session.output.count("bestmove") == 1);
+    REQUIRE(session.output.count("error") == 0);
+}
+
+TEST_CASE("Command lines are split into tokens", "[Uci][Tokens]") {
+    auto tokens = UciTokens("  go\tdepth 12  nodes x  movetime 1000\r\n");
+
+    REQUIRE(tokens.next() == "go");
+    REQUIRE(tokens.next() == "depth");
+    REQUIRE(tokens.nextValue<int>() == 12);
+    REQUIRE(tokens.next() == "nodes");
+    REQUIRE_FALSE(tokens.nextValue<int>().has_value());
+    REQUIRE(tokens.nextValue<std::string>() == "movetime");
+    REQUIRE(tokens.rest() == "1000");
+    REQUIRE(tokens.next().empty());
+    REQUIRE_FALSE(tokens.nextValue<int>().has_value());
+
+    auto position = UciTokens("position fen 4k3/8/8/8/8/8/8/4K3 w - - 0 1 moves e1e2 ");
+    REQUIRE(position.next() == "position");
+    REQUIRE(position.rest() == "fen 4k3/8/8/8/8/8/8/4K3 w - - 0 1 moves e1e2");
+    REQUIRE(position.rest().empty());
+}
+
+static std::string fenAfter(const std::string &fen, const std::vector<Move> &moves) {
+    auto board = Fen::createBoard(fen).value();
+
+    for (auto move : moves)
+        board.makeMove(move);
+
+    return Fen::toFen(board);
+}
+
+/*
+ * Sends every position followed by a search, and returns the FENs and history sizes the engine was asked to search.
+ */
+static std::pair<std::vector<std::string>, std::vector<std::size_t>> searchedPositions(
+        const std::vector<std::string> &positions) {
+    UciSession session;
+
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        session.send("position " + positions[i]);
+        session.send("go depth 1");
+        REQUIRE(session.output.waitFor("bestmove", static_cast<int>(i + 1)));
+    }
+
+    session.finish();
+    return {session.engine().fens(), session.engine().historySizes()};
+}
+
+TEST_CASE("Positions that extend the previous position only play the new moves", "[Uci][Position]") {
+    auto e4 = Move(Square::E2, Square::E4);
+    auto e5 = Move(Square::E7, Square::E5);
+    auto nf3 = Move(Square::G1, Square::F3);
+
+    SECTION("The same position again") {
+        auto [fens, historySizes] = searchedPositions({"startpos moves e2e4 e7e5", "startpos moves e2e4 e7e5"});
+
+        auto expected = fenAfter(Fen::StartingPos, {e4, e5});
+        REQUIRE(fens == std::vector<std::string>{expected, expected});
+        REQUIRE(historySizes == std::vector<std::size_t>{2, 2});
+    }
+
+    SECTION("The previous position followed by new moves") {
+        auto [fens, historySizes] = searchedPositions({"startpos moves e2e4", "startpos moves e2e4 e7e5 g1f3"});
+
+        REQUIRE(fens == std::vector<std::string>{fenAfter(Fen::StartingPos, {e4}),
+                                                 fenAfter(Fen::StartingPos, {e4, e5, nf3})});
+        REQUIRE(historySizes == std::vector<std::size_t>{1, 3});
+    }
+
+    SECTION("The first moves of a position without moves") {
+        auto [fens, historySizes] = searchedPositions({"startpos", "startpos moves e2e4"});
+
+        REQUIRE(fens == std::vector<std::string>{Fen::StartingPos, fenAfter(Fen::StartingPos, {e4})});
+        REQUIRE(historySizes == std::vector<std::size_t>{0, 1});
+    }
+
+    SECTION("A different FEN that starts with the previous FEN") {
+        // https://lichess.org/editor/4k3/8/8/8/8/8/8/4K2R_w_K_-_0_1
+        auto [fens, historySizes] = searchedPositions({"fen 4k3/8/8/8/8/8/8/4K2R w K - 0 1",
+                                                       "fen 4k3/8/8/8/8/8/8/4K2R w K - 0 10"});
+
+        REQUIRE(fens == std::vector<std::string>{"4k3/8/8/8/8/8/8/4K2R w K - 0 1",
+                                                 "4k3/8/8/8/8/8/8/4K2R w K - 0 10"});
+        REQUIRE(historySizes == std::vector<std::size_t>{0, 0});
+    }
+
+    SECTION("A different game after a position with moves") {
+        auto [fens, historySizes] = searchedPositions({"startpos moves e2e4 e7e5", "startpos moves g1f3"});
+
+        REQUIRE(fens == std::vector<std::string>{fenAfter(Fen::StartingPos, {e4, e5}),
+                                                 fenAfter(Fen::StartingPos, {nf3})});
+        REQUIRE(historySizes == std::vector<std::size_t>{2, 1});
+    }
+}
+
+TEST_CASE("Server sessions don't offer options that access the files of the server", "[Uci]") {
+    auto onPool = GENERATE(false, true);
+    CAPTURE(onPool);
+
+    UciSession session({Move(Square::E2, Square::E4)}, false, onPool);
+    session.send("uci");
+    REQUIRE(session.output.waitFor("uciok"));
+
+    REQUIRE(session.output.count("option name Debug Log File") == (onPool ? 0 : 1));
+    REQUIRE(session.output.count("option name EvalFile") == (onPool ? 0 : 1));
+
+    if (onPool) {
+        auto path = std::filesystem::temp_directory_path() / "penguin_uci_tests.log";
+        std::filesystem::remove(path);
+
+        session.send("setoption name Debug Log File value " + path.string());
+        REQUIRE(session.output.waitFor("info string error Illegal option: Debug Log File"));
+
+        session.finish();
+        REQUIRE_FALSE(std::filesystem::exists(path));
+    }
+}
@@ -1,7 +1,9 @@
 #include "Uci.hpp"
+#include "UciTokens.hpp"
 
 #include "Engine.hpp"
 #include "Fen.hpp"
+#include "MoveGenerator.h"
 
 #include <cstdint>
 #include <utility>
@@ -9,6 +11,8 @@
 #include <sstream>
 #include <cstdlib>
 #include <cmath>
+#include <iomanip>
+#include <algorithm>
 
 class UciOptionBase {
 public:
@@ -18,7 +22,7 @@ public:
     virtual std::string name() const = 0;
     virtual std::string type() const = 0;
     virtual void streamOptionCommand(std::ostream& stream) const = 0;
-    virtual bool setValue(Engine& engine, std::istream& stream) const = 0;
+    virtual bool setValue(Engine& engine, UciTokens& tokens) const = 0;
 };
 
 template<typename T>
@@ -55,9 +59,9 @@ public:
         }
     }
 
-    bool setValue(Engine& engine, std::istream& stream) const override {
-        if (Value value; stream >> value) {
-            return setValue(engine, value);
+    bool setValue(Engine& engine, UciTokens& tokens) const override {
+        if (auto value = tokens.nextValue<Value>(); value.has_value()) {
+            return setValue(engine, value.value());
         } else {
             return false;
         }
@@ -121,37 +125,162 @@ private:
     HashInfo hashInfo_;
 };
 
+class UciMultiPvOption : public UciSpinOption<int> {
+public:
+
+    std::string name() const override {
+        return "MultiPV";
+    }
+
+    OptionalValue default_() const override {
+        return 1;
+    }
+
+    OptionalValue min() const override {
+        return 1;
+    }
+
+    OptionalValue max() const override {
+        return Engine::MAX_MULTI_PV;
+    }
+
+    bool setValue(Engine& engine, Value value) const override {
+        return engine.setMultiPv(value);
+    }
+};
+
+class UciStringOption : public UciOption<std::string> {
+public:
+
+    std::string type() const override {
+        return "string";
+    }
+
+    // string values may contain spaces, so the rest of the line is the value
+    bool setValue(Engine& engine, UciTokens& tokens) const override {
+        return setValue(engine, std::string(tokens.rest()));
+    }
+
+    using UciOption<std::string>::setValue;
+};
+
+class UciEvalFileOption : public UciStringOption {
+public:
+
+    std::string name() const override {
+        return "EvalFile";
+    }
+
+    OptionalValue default_() const override {
+        return "<empty>";
+    }
+
+    bool setValue(Engine& engine, Value value) const override {
+        return engine.setEvalFile(value);
+    }
+};
+
+class UciDebugLogFileOption : public UciStringOption {
+public:
+
+    UciDebugLogFileOption(Logger& log) : log_(log) {}
+
+    std::string name() const override {
+        return "Debug Log File";
+    }
+
+    OptionalValue default_() const override {
+        return "";
+    }
+
+    // an empty value disables the log
+    bool setValue(Engine&, Value value) const override {
+        return log_.open(value);
+    }
+
+private:
+
+    Logger& log_;
+};
+
+Uci::Uci(std::unique_ptr<Engine> engine,
+         std::istream& cmdIn,
+         std::ostream& cmdOut
+) : Uci(std::move(engine), cmdIn, cmdOut, nullptr) {}
+
 Uci::Uci(std::unique_ptr<Engine> engine,
          std::istream& cmdIn,
          std::ostream& cmdOut,
-         std::ostream& log
-) : engine_(std::move(engine)), cmdIn_(cmdIn), cmdOut_(cmdOut), log_(log) {
+         SearchPool& pool
+) : Uci(std::move(engine), cmdIn, cmdOut, &pool) {}
+
+Uci::Uci(std::unique_ptr<Engine> engine,
+         std::istream& cmdIn,
+         std::ostream& cmdOut,
+         SearchPool* pool
+) : engine_(std::move(engine)), cmdIn_(cmdIn), cmdOut_(cmdOut), pool_(pool) {
     if (auto hashInfo = engine_->hashInfo(); hashInfo) {
         auto hashOption = std::make_unique<UciHashOption>(*hashInfo);
         options_[hashOption->name()] = std::move(hashOption);
     }
+
+    // the network is shared by all sessions of a server, it is loaded by the server; a client of a server must not
+    // write to the files of the server either
+    if (pool_ == nullptr) {
+        auto evalFileOption = std::make_unique<UciEvalFileOption>();
+        options_[evalFileOption->name()] = std::move(evalFileOption);
+
+        auto debugLogFileOption = std::make_unique<UciDebugLogFileOption>(log_);
+        options_[debugLogFileOption->name()] = std::move(debugLogFileOption);
+    }
+
+    auto multiPvOption = std::make_unique<UciMultiPvOption>();
+    options_[multiPvOption->name()] = std::move(multiPvOption);
+
+    engine_->setSearchListener(this);
+
+    if (pool_ == nullptr) {
+        searchThread_ = std::thread(&Uci::searchLoop, this);
+    }
 }
 
-// Needed here because Engine is only forward-declared in Uci.hpp causing an
-// error when compiling the destructor of std::unique_ptr.
-Uci::~Uci() = default;
+Uci::~Uci() {
+    finishSearch();
 
-void Uci::run() {
-    log_ << "UCI engine started" << std::endl;
+    {
+        std::lock_guard lock(searchMutex_);
+        quit_ = true;
+    }
+
+    searchCondition_.notify_all();
 
-    while (!cmdIn_.eof()) {
+    if (searchThread_.joinable()) {
+        searchThread_.join();
+    }
+
+    engine_->setSearchListener(nullptr);
+}
+
+void Uci::run() {
+    while (!cmdIn_.eof() && !quit_) {
         std::string line;
         std::getline(cmdIn_, line);
         runCommand(line);
     }
+
+    // the client of a server session is gone, its search would only keep a thread of the pool busy
+    if (pool_ != nullptr && cmdIn_.eof()) {
+        signals_->stop = true;
+    }
+
+    finishSearch();
 }
 
-void Uci::runCommand(const std::string& line) {
-    log_ << "> " << line << std::endl;
+void Uci::runCommand(std::string_view line) {
+    log_.write(Logger::Level::Info, "> ", line);
 
-    auto stream = std::stringstream(line);
-    auto command = std::string();
-    stream >> command;
+    auto stream = UciTokens(line);
+    auto command = stream.next();
 
     if (command == "uci") {
         uciCommand(stream);
@@ -165,12 +294,16 @@ void Uci::runCommand(const std::string& line) {
         positionCommand(stream);
     } else if (command == "go") {
         goCommand(stream);
+    } else if (command == "stop") {
+        stopCommand(stream);
+    } else if (command == "ponderhit") {
+        ponderhitCommand(stream);
     } else if (command == "quit") {
         quitCommand(stream);
     }
 }
 
-void Uci::uciCommand(std::istream&) {
+void Uci::uciCommand(UciTokens&) {
     std::stringstream nameCommand;
     nameCommand << "id name " << engine_->name() << " " << engine_->version();
     sendCommand(nameCommand.str());
@@ -180,29 +313,60 @@ void Uci::uciCommand(std::istream&) {
     sendCommand(authorCommand.str());
 
     sendOptions();
+    sendCommand("info string slider attacks " + MoveGenerator::sliderBackendName());
     sendCommand("uciok");
 }
 
-void Uci::isreadyCommand(std::istream&) {
+void Uci::isreadyCommand(UciTokens&) {
     sendCommand("readyok");
 }
 
-void Uci::ucinewgameCommand(std::istream&) {
+void Uci::ucinewgameCommand(UciTokens&) {
+    finishSearch();
     engine_->newGame();
+    history_.clear();
+    position_.clear();
 }
 
-void Uci::positionCommand(std::istream& stream) {
-    auto type = std::string();
-    stream >> type;
+void Uci::positionCommand(UciTokens& tokens) {
+    finishSearch();
+
+    auto position = tokens.rest();
+
+    // GUIs send the previous position followed by the moves that were played since, only the new moves are applied
+    if (!position_.empty() && position.starts_with(position_) &&
+        (position.size() == position_.size() || position[position_.size()] == ' ')) {
+        auto newMoves = UciTokens(position.substr(position_.size()));
+
+        if (positionHasMoves_ || newMoves.next() == "moves") {
+            // the board no longer matches any position after an illegal move, the next position is set up again
+            if (!makeMoves(newMoves)) {
+                position_.clear();
+                return;
+            }
+
+            position_.append(position.substr(position_.size()));
+            positionHasMoves_ = true;
+
+            log_.write(Logger::Level::Debug, board_);
+            return;
+        }
+    }
+
+    auto positionTokens = UciTokens(position);
+    auto type = positionTokens.next();
 
     auto newBoard = Board::Optional();
 
     if (type == "startpos") {
         newBoard = Fen::createBoard(Fen::StartingPos);
     } else if (type == "fen") {
-        newBoard = Fen::createBoard(stream);
+        auto fen = positionTokens.rest();
+        auto moves = std::min(fen.find(" moves"), fen.size());
+        positionTokens = UciTokens(fen.substr(moves));
+        newBoard = Fen::createBoard(fen.substr(0, moves));
     } else {
-        error("Illegal position type " + type);
+        error("Illegal position type " + std::string(type));
         return;
     }
 
@@ -212,49 +376,65 @@ void Uci::positionCommand(std::istream& stream) {
     }
 
     board_ = newBoard.value();
+    history_.clear();
 
-    auto moves = std::string();
-    stream >> moves;
+    positionHasMoves_ = positionTokens.next() == "moves";
 
-    if (moves == "moves") {
-        while (!stream.eof()) {
-            auto uciMove = std::string();
-            stream >> uciMove;
+    if (positionHasMoves_ && !makeMoves(positionTokens)) {
+        position_.clear();
+        return;
+    }
 
-            if (uciMove.empty()) {
-                continue;
-            }
+    position_ = position;
 
-            auto optMove = Move::fromUci(uciMove);
+    log_.write(Logger::Level::Debug, board_);
+}
 
-            if (!optMove.has_value()) {
-                error("Illegal move " + uciMove);
-                return;
-            }
+/*
+ * Plays the given moves on the current board, the hashes of the positions before the moves are added to the history.
+ * Returns false if one of the moves is invalid, the moves before it are played.
+ */
+bool Uci::makeMoves(UciTokens& moves) {
+    for (auto uciMove = moves.next(); !uciMove.empty(); uciMove = moves.next()) {
+        auto optMove = Move::fromUci(uciMove);
 
-            board_.makeMove(optMove.value());
+        if (!optMove.has_value()) {
+            error("Illegal move " + std::string(uciMove));
+            return false;
         }
-    }
 
-    log_ << board_ << std::endl;
-}
-
-template<typename T>
-static std::optional<T> readValue(std::istream& stream) {
-    if (T value; stream >> value) {
-        return value;
-    } else {
-        return std::nullopt;
+        history_.push_back(board_.hash());
+        board_.makeMove(optMove.value());
     }
+
+    return true;
 }
 
-TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
+SearchLimits Uci::readSearchLimits(UciTokens& tokens) {
     std::optional<unsigned> wtime, winc, btime, binc, movestogo;
+    SearchLimits limits;
+
+    for (auto command = tokens.next(); !command.empty(); command = tokens.next()) {
+        if (command == "infinite") {
+            limits.infinite = true;
+            continue;
+        } else if (command == "ponder") {
+            limits.ponder = true;
+            continue;
+        } else if (command == "nodes") {
+            limits.nodes = tokens.nextValue<std::uint64_t>();
+            continue;
+        }
 
-    for (std::string command; stream >> command;) {
-        auto value = readValue<unsigned>(stream);
+        auto value = tokens.nextValue<unsigned>();
 
-        if (command == "wtime") {
+        if (command == "depth") {
+            limits.depth = value;
+        } else if (command == "movetime" && value.has_value()) {
+            limits.moveTime = std::chrono::milliseconds(value.value());
+        } else if (command == "mate") {
+            limits.mate = value;
+        } else if (command == "wtime") {
             wtime = value;
         } else if (command == "winc") {
             winc = value;
@@ -264,9 +444,6 @@ TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
             binc = value;
         } else if (command == "movestogo") {
             movestogo = value;
-        } else if (command == "infinite") {
-            error("go infinite not supported");
-            return std::nullopt;
         }
     }
 
@@ -281,55 +458,217 @@ TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
         timeInfo.white = whiteTime;
         timeInfo.black = blackTime;
         timeInfo.movesToGo = movestogo;
-        return timeInfo;
-    } else {
-        return std::nullopt;
+        limits.timeInfo = timeInfo;
     }
+
+    return limits;
 }
 
-void Uci::goCommand(std::istream& stream) {
-    auto timeInfo = readTimeInfo(stream);
-    auto pv = engine_->pv(board_, timeInfo);
+void Uci::goCommand(UciTokens& tokens) {
+    finishSearch();
 
-    if (pv.length() == 0) {
-        error("Engine returned no PV");
+    auto limits = readSearchLimits(tokens);
+    signals_ = std::make_shared<SearchSignals>();
+    limits.signals = signals_.get();
+
+    {
+        std::lock_guard lock(searchMutex_);
+        pendingSearch_ = limits;
+        pendingSince_ = std::chrono::steady_clock::now();
+        searching_ = true;
+        bestMoveAllowed_ = !limits.infinite && !limits.ponder;
+    }
+
+    if (pool_ != nullptr && (limits.infinite || limits.ponder)) {
+        // the best move is deferred until stop or ponderhit, so an interrupted search only ends early
+        pool_->submitBackground([this] { runPendingSearch(); }, [signals = signals_] {
+            if (!signals->ponderHit) {
+                signals->stop = true;
+            }
+        });
+    } else if (pool_ != nullptr) {
+        auto remainingTime = std::optional<std::chrono::milliseconds>();
+
+        if (limits.timeInfo.has_value()) {
+            auto& timeInfo = limits.timeInfo.value();
+            remainingTime = board_.turn() == PieceColor::White ? timeInfo.white.timeLeft : timeInfo.black.timeLeft;
+        }
+
+        pool_->submit(remainingTime, [this] { runPendingSearch(); });
+    }
+
+    searchCondition_.notify_all();
+}
+
+void Uci::stopCommand(UciTokens&) {
+    signals_->stop = true;
+    allowBestMove();
+}
+
+/*
+ * The opponent played the expected move, the pondering search continues as a normal search on the clock.
+ */
+void Uci::ponderhitCommand(UciTokens&) {
+    signals_->ponderHit = true;
+    allowBestMove();
+}
+
+/*
+ * Allows the current search to send its best move, or sends it if the search already finished.
+ */
+void Uci::allowBestMove() {
+    auto bestMove = std::optional<std::string>();
+
+    {
+        std::lock_guard lock(searchMutex_);
+        bestMoveAllowed_ = true;
+        bestMove.swap(deferredBestMove_);
+
+        if (bestMove.has_value()) {
+            searching_ = false;
+        }
+    }
+
+    searchCondition_.notify_all();
+
+    if (bestMove.has_value()) {
+        sendCommand(bestMove.value());
+    }
+}
+
+void Uci::quitCommand(UciTokens&) {
+    std::lock_guard lock(searchMutex_);
+    quit_ = true;
+}
+
+/*
+ * Waits until the current search sent its best move. Pondering and infinite searches never end on their own, so they
+ * are stopped first.
+ */
+void Uci::finishSearch() {
+    std::unique_lock lock(searchMutex_);
+
+    if (!searching_) {
         return;
     }
 
-    log_ << "PV: " << pv << std::endl;
-    sendPvInfo(pv);
+    if (!bestMoveAllowed_ || quit_) {
+        signals_->stop = true;
+        lock.unlock();
+        allowBestMove();
+        lock.lock();
+    }
 
-    auto bestMove = *pv.begin();
-    board_.makeMove(bestMove);
-    log_ << board_ << std::endl;
+    searchCondition_.wait(lock, [this] { return !searching_; });
+}
+
+/*
+ * Runs the requested searches on the search thread until this object is destroyed.
+ */
+void Uci::searchLoop() {
+    std::unique_lock lock(searchMutex_);
+
+    while (true) {
+        searchCondition_.wait(lock, [this] { return pendingSearch_.has_value() || quit_; });
+
+        if (!pendingSearch_.has_value()) {
+            return;
+        }
 
+        lock.unlock();
+        runPendingSearch();
+        lock.lock();
+    }
+}
+
+/*
+ * Runs the requested search. The time the search waited to be started, e.g. for a thread of the pool, is taken from the
+ * clock of the side to move.
+ */
+void Uci::runPendingSearch() {
+    std::unique_lock lock(searchMutex_);
+
+    auto limits = pendingSearch_.value();
+    pendingSearch_.reset();
+
+    if (limits.timeInfo.has_value()) {
+        auto& timeInfo = limits.timeInfo.value();
+        auto& time = board_.turn() == PieceColor::White ? timeInfo.white : timeInfo.black;
+        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - pendingSince_);
+        time.timeLeft = std::max(time.timeLeft - waited, std::chrono::milliseconds(1));
+    }
+
+    lock.unlock();
+    auto bestMove = search(limits);
+    lock.lock();
+
+    // the best move of a pondering or infinite search is only sent after ponderhit or stop, the thread is not kept
+    if (!bestMoveAllowed_) {
+        deferredBestMove_ = bestMove;
+        return;
+    }
+
+    lock.unlock();
+    sendCommand(bestMove);
+    lock.lock();
+    searching_ = false;
+    searchCondition_.notify_all();
+}
+
+/*
+ * Searches the current position and returns the best move command.
+ */
+std::string Uci::search(const SearchLimits& limits) {
+    engine_->setGameHistory(history_);
+    sentIterationInfo_ = false;
+    auto pv = engine_->pv(board_, limits);
+
+    // checkmate or stalemate, there is no move to play, UCI uses the null move for that
+    if (pv.length() == 0) {
+        log_.write(Logger::Level::Debug, "No legal moves");
+        sendPvInfo(pv);
+        return "bestmove 0000";
+    }
+
+    log_.write(Logger::Level::Debug, "PV: ", pv);
+
+    // the last iteration already reported the PV, unless the engine did not search
+    if (!sentIterationInfo_) {
+        sendPvInfo(pv);
+    }
+
+    sendStatistics();
+
+    auto bestMove = *pv.begin();
     auto bestMoveCmd = std::stringstream();
     bestMoveCmd << "bestmove " << bestMove;
-    sendCommand(bestMoveCmd.str());
-}
 
-void Uci::quitCommand(std::istream&) {
-    std::exit(EXIT_SUCCESS);
+    // the expected reply of the opponent is the move to ponder on
+    if (pv.length() > 1) {
+        bestMoveCmd << " ponder " << *std::next(pv.begin());
+    }
+
+    return bestMoveCmd.str();
 }
 
-void Uci::setoptionCommand(std::istream& stream) {
-    std::string nameCommand;
-    stream >> nameCommand;
+void Uci::setoptionCommand(UciTokens& tokens) {
+    finishSearch();
 
-    if (nameCommand != "name") {
+    if (tokens.next() != "name") {
         error("Illegal setoption: did not start with 'name'");
         return;
     }
 
-    std::string name;
-    stream >> name;
+    auto name = std::string(tokens.next());
 
-    for (std::string nextPart; stream >> nextPart;) {
+    for (auto nextPart = tokens.next(); !nextPart.empty(); nextPart = tokens.next()) {
         if (nextPart == "value") {
             break;
         }
 
-        name += ' ' + nextPart;
+        name += ' ';
+        name += nextPart;
     }
 
     // We could get here without a "value" command. This is by design because
@@ -341,16 +680,13 @@ void Uci::setoptionCommand(std::istream& stream) {
         return;
     }
 
-    if (!optionIt->second->setValue(*engine_, stream)) {
+    if (!optionIt->second->setValue(*engine_, tokens)) {
         error("Illegal option value");
         return;
     }
 }
 
-void Uci::sendPvInfo(const PrincipalVariation& pv) {
-    auto stream = std::stringstream();
-    stream << "info score ";
-
+static void streamScore(std::ostream& stream, const PrincipalVariation& pv) {
     auto score = pv.score();
 
     if (pv.isMate()) {
@@ -360,12 +696,71 @@ void Uci::sendPvInfo(const PrincipalVariation& pv) {
     } else {
         stream << "cp " << score;
     }
+}
 
-    stream << " pv";
-
+static void streamMoves(std::ostream& stream, const PrincipalVariation& pv) {
     for (auto move : pv) {
         stream << ' ' << move;
     }
+}
+
+void Uci::iterationCompleted(const SearchInfo& info) {
+    sentIterationInfo_ = true;
+
+    auto milliseconds = std::max(info.time.count(), std::int64_t(1));
+
+    auto stream = std::stringstream();
+    stream << "info depth " << info.depth
+           << " seldepth " << info.selDepth
+           << " multipv " << info.multiPv
+           << " score ";
+    streamScore(stream, info.pv);
+    stream << " nodes " << info.nodes
+           << " nps " << info.nodes * 1000 / milliseconds
+           << " hashfull " << info.hashFull
+           << " time " << info.time.count()
+           << " pv";
+    streamMoves(stream, info.pv);
+
+    sendCommand(stream.str());
+}
+
+void Uci::currentMove(int depth, const Move& move, int moveNumber) {
+    auto stream = std::stringstream();
+    stream << "info depth " << depth
+           << " currmove " << move
+           << " currmovenumber " << moveNumber;
+
+    sendCommand(stream.str());
+}
+
+void Uci::sendPvInfo(const PrincipalVariation& pv) {
+    auto stream = std::stringstream();
+    stream << "info score ";
+    streamScore(stream, pv);
+    stream << " pv";
+    streamMoves(stream, pv);
+
+    sendCommand(stream.str());
+}
+
+void Uci::sendStatistics() {
+    auto statistics = engine_->statistics();
+
+    if (!statistics.has_value()) {
+        return;
+    }
+
+    auto evaluations = statistics->evaluations;
+    auto hitRate = evaluations == 0 ? 0.0 : 100.0 * statistics->evalCacheHits / evaluations;
+    auto seconds = std::max(statistics->time.count(), std::int64_t(1)) / 1000.0;
+
+    auto stream = std::stringstream();
+    stream << std::fixed << std::setprecision(1);
+    stream << "info string nodes " << statistics->nodes
+           << " evals " << evaluations
+           << " evalcachehits " << hitRate << '%'
+           << " evals/s " << std::llround(evaluations / seconds);
 
     sendCommand(stream.str());
 }
@@ -379,11 +774,25 @@ void Uci::sendOptions() {
 }
 
 void Uci::sendCommand(const std::string& command) {
-    log_ << "< " << command << std::endl;
+    log_.write(Logger::Level::Info, "< ", command);
+
+    std::lock_guard lock(outputMutex_);
     cmdOut_ << command << std::endl;
 }
 
 void Uci::error(const std::string& msg) {
-    log_ << "UCI error: " << msg << std::endl;
+    log_.write(Logger::Level::Error, "UCI error: ", msg);
+
+    // the other sessions of a server continue
+    if (pool_ != nullptr) {
+        sendCommand("info string error " + msg);
+
+        std::lock_guard lock(searchMutex_);
+        quit_ = true;
+        return;
+    }
+
+    // exit does not destroy this object, so the buffered log is written here
+    log_.close();
     std::exit(EXIT_FAILURE);
 }
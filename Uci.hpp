@@ -2,50 +2,116 @@
 #define CHESS_ENGINE_UCI_HPP
 
 #include "Board.hpp"
-#include "TimeInfo.hpp"
+#include "SearchLimits.hpp"
+#include "Engine.hpp"
+#include "Logger.hpp"
+#include "SearchPool.hpp"
 
 #include <string>
+#include <string_view>
 #include <iosfwd>
 #include <memory>
 #include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <optional>
+#include <chrono>
 
-class Engine;
-class PrincipalVariation;
 class UciOptionBase;
+class UciTokens;
 
-class Uci {
+class Uci : private SearchListener {
 public:
 
+    Uci(std::unique_ptr<Engine> engine,
+        std::istream& cmdIn,
+        std::ostream& cmdOut);
+
+    /*
+     * A session of a server: the searches run on the shared pool, an error ends the session instead of the process, and
+     * options that change the state of the whole process are not offered.
+     */
     Uci(std::unique_ptr<Engine> engine,
         std::istream& cmdIn,
         std::ostream& cmdOut,
-        std::ostream& log);
+        SearchPool& pool);
+
     ~Uci();
 
     void run();
 
 private:
 
-    void runCommand(const std::string& line);
-    void uciCommand(std::istream& stream);
-    void isreadyCommand(std::istream& stream);
-    void ucinewgameCommand(std::istream& stream);
-    void positionCommand(std::istream& stream);
-    void goCommand(std::istream& stream);
-    void quitCommand(std::istream& stream);
-    void setoptionCommand(std::istream& stream);
-    TimeInfo::Optional readTimeInfo(std::istream& stream);
+    Uci(std::unique_ptr<Engine> engine,
+        std::istream& cmdIn,
+        std::ostream& cmdOut,
+        SearchPool* pool);
+
+    void runCommand(std::string_view line);
+    void uciCommand(UciTokens& tokens);
+    void isreadyCommand(UciTokens& tokens);
+    void ucinewgameCommand(UciTokens& tokens);
+    void positionCommand(UciTokens& tokens);
+    void goCommand(UciTokens& tokens);
+    void stopCommand(UciTokens& tokens);
+    void ponderhitCommand(UciTokens& tokens);
+    void quitCommand(UciTokens& tokens);
+    void setoptionCommand(UciTokens& tokens);
+    bool makeMoves(UciTokens& moves);
+    SearchLimits readSearchLimits(UciTokens& tokens);
+    void searchLoop();
+    void runPendingSearch();
+    std::string search(const SearchLimits& limits);
+    void finishSearch();
+    void allowBestMove();
+    void iterationCompleted(const SearchInfo& info) override;
+    void currentMove(int depth, const Move& move, int moveNumber) override;
     void sendPvInfo(const PrincipalVariation& pv);
+    void sendStatistics();
     void sendOptions();
     void sendCommand(const std::string& line);
     void error(const std::string& msg);
 
     std::unique_ptr<Engine> engine_;
     Board board_;
+    std::vector<Board::U64> history_;
+    // arguments of the last position command, the board and history are the result of this position
+    std::string position_;
+    bool positionHasMoves_ = false;
     std::istream& cmdIn_;
     std::ostream& cmdOut_;
-    std::ostream& log_;
+    Logger log_;
     std::map<std::string, std::unique_ptr<UciOptionBase>> options_;
+    // whether the engine reported an iteration of the current search
+    bool sentIterationInfo_ = false;
+
+    // searches run on a thread that lives as long as this object, so the caches of the search stay warm between moves,
+    // or on the pool of a server
+    std::thread searchThread_;
+    SearchPool* pool_;
+    std::mutex searchMutex_;
+    std::condition_variable searchCondition_;
+    // every search gets its own signals, so the pool can't interrupt a later search of this session by accident
+    std::shared_ptr<SearchSignals> signals_ = std::make_shared<SearchSignals>();
+    // search that is requested but not yet started
+    std::optional<SearchLimits> pendingSearch_;
+    // when the pending search was requested, the clock of the side to move runs from then on
+    std::chrono::steady_clock::time_point pendingSince_;
+    // whether a search is requested or running, it ends when its best move is sent
+    bool searching_ = false;
+    // whether the best move of the current search may be sent, pondering and infinite searches wait for stop or
+    // ponderhit
+    bool bestMoveAllowed_ = false;
+    // best move of a finished search that waits for stop or ponderhit, it is sent by the command that allows it
+    std::optional<std::string> deferredBestMove_;
+    // written under the search mutex, so the search thread sees it while waiting, and read without it by run()
+    std::atomic<bool> quit_ = false;
+
+    // the search thread sends info while commands are handled, the log is thread-safe on its own
+    std::mutex outputMutex_;
 };
 
 #endif
@@ -0,0 +1,61 @@
+#ifndef CHESS_ENGINE_UCITOKENS_HPP
+#define CHESS_ENGINE_UCITOKENS_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Splits a command line into tokens separated by whitespace. Tokens are views into the line, nothing is copied.
+ */
+class UciTokens {
+public:
+
+    explicit UciTokens(std::string_view line) : rest_(line) {}
+
+    // returns the next token, or an empty token at the end of the line
+    std::string_view next() {
+        skipWhitespace();
+        auto token = rest_.substr(0, rest_.find_first_of(WHITESPACE));
+        rest_.remove_prefix(token.size());
+        return token;
+    }
+
+    // returns the next token as a number or string, the token is consumed even if it is not a number
+    template<typename T>
+    std::optional<T> nextValue() {
+        auto token = next();
+        auto end = token.data() + token.size();
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            return std::string(token);
+        } else if (T value{}; !token.empty() && std::from_chars(token.data(), end, value).ptr == end) {
+            return value;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    // returns all remaining tokens without the surrounding whitespace
+    std::string_view rest() {
+        skipWhitespace();
+        auto rest = rest_.substr(0, rest_.find_last_not_of(WHITESPACE) + 1);
+        rest_ = {};
+        return rest;
+    }
+
+private:
+
+    static constexpr std::string_view WHITESPACE = " \t\r\n";
+
+    void skipWhitespace() {
+        rest_.remove_prefix(std::min(rest_.find_first_not_of(WHITESPACE), rest_.size()));
+    }
+
+    std::string_view rest_;
+};
+
+#endif